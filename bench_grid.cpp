@@ -0,0 +1,162 @@
+///////////////////////////////////////////////////////////////////
+// 文	件：bench_grid.cpp
+// 功	能：棋盘存储层性能测试。在4096x4096的随机地图上，分别用行优先
+//			和分块存储运行Dial单源搜索，比较耗时（两者结果应完全相同）；
+//			再在无权地图上比较单线程与多线程广度优先搜索（结果应与Dial相同）
+//	用	法：bench_grid [边长] [重复次数] [线程数]
+// 作	者：gengjian1203
+// 邮	箱：gengjian1203@foxmail.com
+///////////////////////////////////////////////////////////////////
+#include <stdio.h>
+#include <stdlib.h>
+#include <limits.h>
+#include <chrono>
+#include <thread>
+#include "grid.h"
+#include "search.h"
+#include "bfs.h"
+
+///////////////////////////////////////////////////////////////////
+// 函	数：buildRandomGrid
+// 作	用：生成随机地图：约25%障碍物，约10%慢行区域（代价2~9）
+// 参	数：MyGrid& grid		输出棋盘
+// 参	数：int nSide		边长
+// 参	数：int nLayout		存储顺序
+// 参	数：bool bWeighted	是否生成慢行区域（否则均为代价1）
+// 返	回：bool		内存申请失败返回假
+///////////////////////////////////////////////////////////////////
+static bool buildRandomGrid(MyGrid& grid, int nSide, int nLayout, bool bWeighted)
+{
+    if (!grid.create(nSide, nSide, nLayout))
+    {
+        return false;
+    }
+    // 同一种子保证两种存储顺序的地图相同
+    srand(20141020);
+    for (int y = 0; y < nSide; y++)
+    {
+        for (int x = 0; x < nSide; x++)
+        {
+            int r = rand() % 100;
+            grid.setCost(x, y, (25 > r) ? 0 : (((35 > r) && bWeighted) ? (2 + r % 8) : 1));
+        }
+    }
+    grid.setCost(nSide / 2, nSide / 2, 1);
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////
+// 函	数：benchLayout
+// 作	用：测试一种存储顺序，输出最短耗时及结果校验和
+// 参	数：int nSide		边长
+// 参	数：int nRepeat		重复次数
+// 参	数：int nLayout		存储顺序
+// 返	回：void
+///////////////////////////////////////////////////////////////////
+static void benchLayout(int nSide, int nRepeat, int nLayout)
+{
+    MyGrid grid;
+    DialSearch dial;
+    double dBest = 0.0;
+    long long llChecksum = 0;
+    int nReached = 0;
+
+    if (!buildRandomGrid(grid, nSide, nLayout, true))
+    {
+        printf("Out of memory.\n");
+        return;
+    }
+    for (int i = 0; i < nRepeat; i++)
+    {
+        std::chrono::steady_clock::time_point tBegin = std::chrono::steady_clock::now();
+        dial.run(grid, grid.cell(nSide / 2, nSide / 2));
+        std::chrono::steady_clock::time_point tEnd = std::chrono::steady_clock::now();
+        double dTime = std::chrono::duration<double, std::milli>(tEnd - tBegin).count();
+        if ((0 == i) || (dTime < dBest))
+        {
+            dBest = dTime;
+        }
+    }
+    // 按坐标校验，与存储顺序无关
+    for (int y = 0; y < nSide; y++)
+    {
+        for (int x = 0; x < nSide; x++)
+        {
+            int nDist = dial.distance(grid.cell(x, y));
+            if (INT_MAX != nDist)
+            {
+                llChecksum += nDist;
+                nReached++;
+            }
+        }
+    }
+    printf("%-10s %dx%d  best %.1f ms  reached %d  checksum %lld\n",
+        (GRID_TILED == nLayout) ? "tiled" : "row-major", nSide, nSide, dBest, nReached, llChecksum);
+}
+
+///////////////////////////////////////////////////////////////////
+// 函	数：benchBfs
+// 作	用：在无权地图上测试多线程广度优先搜索，输出最短耗时及与Dial
+//			结果是否一致
+// 参	数：int nSide		边长
+// 参	数：int nRepeat		重复次数
+// 参	数：int nThreads		线程数
+// 返	回：void
+///////////////////////////////////////////////////////////////////
+static void benchBfs(int nSide, int nRepeat, int nThreads)
+{
+    MyGrid grid;
+    DialSearch dial;
+    ParallelBFS bfs;
+    double dBest = 0.0;
+    int nMismatch = 0;
+
+    if (!buildRandomGrid(grid, nSide, GRID_TILED, false))
+    {
+        printf("Out of memory.\n");
+        return;
+    }
+    int nSource = grid.cell(nSide / 2, nSide / 2);
+    bfs.setThreads(nThreads);
+    for (int i = 0; i < nRepeat; i++)
+    {
+        std::chrono::steady_clock::time_point tBegin = std::chrono::steady_clock::now();
+        bfs.run(grid, nSource);
+        std::chrono::steady_clock::time_point tEnd = std::chrono::steady_clock::now();
+        double dTime = std::chrono::duration<double, std::milli>(tEnd - tBegin).count();
+        if ((0 == i) || (dTime < dBest))
+        {
+            dBest = dTime;
+        }
+    }
+    dial.run(grid, nSource);
+    for (int c = 0; c < grid.size(); c++)
+    {
+        if (dial.distance(c) != bfs.distance(c))
+        {
+            nMismatch++;
+        }
+    }
+    printf("bfs x%-5d %dx%d  best %.1f ms  levels %d (parallel %d, bottom-up %d)  mismatch %d\n",
+        bfs.threads(), nSide, nSide, dBest, bfs.levelCount(), bfs.parallelLevelCount(),
+        bfs.bottomUpLevelCount(), nMismatch);
+}
+
+///////////////////////////////////////////////////////////////////
+// 函	数：main
+// 作	用：程序主函数
+// 参	数：int argc		输入参数个数
+// 参	数：char* argv[]	命令行参数
+// 返	回：int		给操作系统返回执行情况
+///////////////////////////////////////////////////////////////////
+int main(int argc, char* argv[])
+{
+    int nSide = (1 < argc) ? atoi(argv[1]) : 4096;
+    int nRepeat = (2 < argc) ? atoi(argv[2]) : 3;
+    benchLayout(nSide, nRepeat, GRID_ROW_MAJOR);
+    benchLayout(nSide, nRepeat, GRID_TILED);
+    int nThreads = (3 < argc) ? atoi(argv[3]) : (int)std::thread::hardware_concurrency();
+    benchBfs(nSide, nRepeat, 1);
+    benchBfs(nSide, nRepeat, (1 > nThreads) ? 1 : nThreads);
+    return 0;
+}
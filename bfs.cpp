@@ -0,0 +1,441 @@
+///////////////////////////////////////////////////////////////////
+// 文	件：bfs.cpp
+// 功	能：多线程逐层广度优先搜索（自顶向下/自底向上自动切换）
+// 作	者：gengjian1203
+// 邮	箱：gengjian1203@foxmail.com
+///////////////////////////////////////////////////////////////////
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <new>
+#include <system_error>
+#include "bfs.h"
+
+// 处理方式
+#define BFS_MODE_DONE 0
+#define BFS_MODE_TOP_DOWN 1
+#define BFS_MODE_BOTTOM_UP 2
+
+///////////////////////////////////////////////////////////////////
+// 函	数：ParallelBFS
+// 作	用：构造函数
+// 参	数：void
+///////////////////////////////////////////////////////////////////
+ParallelBFS::ParallelBFS()
+{
+    m_pGrid = NULL;
+    m_pDist = NULL;
+    m_pFrontier = NULL;
+    m_pNext = NULL;
+    m_nFrontier = 0;
+    m_nNextCount.store(0);
+    m_nLevel = 0;
+    m_nMode = BFS_MODE_DONE;
+    m_nPassable = 0;
+    m_nVisited = 0;
+    m_nThreads = 1;
+    m_nActive = 1;
+    m_nArrived.store(0);
+    m_nGeneration.store(0);
+    m_nPoolSize = 1;
+    m_nJob = 0;
+    m_nRunning = 0;
+    m_bQuit = false;
+    m_nParallelLevels = 0;
+    m_nBottomUpLevels = 0;
+    m_nCapacity = 0;
+}
+
+///////////////////////////////////////////////////////////////////
+// 函	数：~ParallelBFS
+// 作	用：析构函数
+///////////////////////////////////////////////////////////////////
+ParallelBFS::~ParallelBFS()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_bQuit = true;
+    }
+    m_wake.notify_all();
+    for (int i = 1; i < m_nPoolSize; i++)
+    {
+        m_worker[i].join();
+    }
+    delete[] m_pDist;
+    free(m_pFrontier);
+    free(m_pNext);
+}
+
+///////////////////////////////////////////////////////////////////
+// 函	数：setThreads
+// 作	用：设置线程数
+// 参	数：int nThreads		线程数（含调用线程）
+// 返	回：void
+///////////////////////////////////////////////////////////////////
+void ParallelBFS::setThreads(int nThreads)
+{
+    m_nThreads = (1 > nThreads) ? 1 : ((BFS_MAX_THREAD < nThreads) ? BFS_MAX_THREAD : nThreads);
+}
+
+///////////////////////////////////////////////////////////////////
+// 函	数：reserve
+// 作	用：预先申请nSize个格子的缓冲区（只增不减）
+// 参	数：int nSize		格子数
+// 返	回：bool		内存申请失败返回假
+///////////////////////////////////////////////////////////////////
+bool ParallelBFS::reserve(int nSize)
+{
+    if (nSize <= m_nCapacity)
+    {
+        return true;
+    }
+    delete[] m_pDist;
+    free(m_pFrontier);
+    free(m_pNext);
+    m_pDist = new (std::nothrow) std::atomic<int>[nSize];
+    m_pFrontier = (int*)malloc(nSize * sizeof(int));
+    m_pNext = (int*)malloc(nSize * sizeof(int));
+    if ((NULL == m_pDist) || (NULL == m_pFrontier) || (NULL == m_pNext))
+    {
+        m_nCapacity = 0;
+        return false;
+    }
+    m_nCapacity = nSize;
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////
+// 函	数：run
+// 作	用：逐层广度优先搜索，计算源点到所有格子的步数（所有可行格子
+//			代价视为1），结果通过distance查询。多线程时唤醒常驻工作
+//			线程（不足时补建，系统无法再创建线程时只用已有的线程），
+//			调用线程作为0号参与，结束后等待其他线程回到等待状态
+// 参	数：const MyGrid& grid	棋盘
+// 参	数：int nSource		源点格子下标
+// 返	回：bool		内存申请失败返回假
+///////////////////////////////////////////////////////////////////
+bool ParallelBFS::run(const MyGrid& grid, int nSource)
+{
+    if (!reserve(grid.size()))
+    {
+        return false;
+    }
+    m_pGrid = &grid;
+    m_nActive = (BFS_SERIAL_SIZE > grid.size()) ? 1 : m_nThreads;
+    m_pFrontier[0] = nSource;
+    m_nFrontier = 1;
+    m_nLevel = 0;
+    m_nParallelLevels = 0;
+    m_nBottomUpLevels = 0;
+    m_nArrived.store(0);
+    if (1 == m_nActive)
+    {
+        workerMain(0);
+        return true;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (; m_nPoolSize < m_nActive; m_nPoolSize++)
+        {
+            try
+            {
+                m_worker[m_nPoolSize] = std::thread(&ParallelBFS::poolMain, this, m_nPoolSize, m_nJob);
+            }
+            catch (const std::system_error&)
+            {
+                // 系统无法再创建线程：本次只用已有的线程
+                m_nActive = m_nPoolSize;
+                break;
+            }
+        }
+        m_nJob++;
+        m_nRunning = m_nPoolSize - 1;
+    }
+    m_wake.notify_all();
+    workerMain(0);
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (0 < m_nRunning)
+    {
+        m_idle.wait(lock);
+    }
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////
+// 函	数：poolMain
+// 作	用：常驻工作线程：等待搜索序号变化后参与本次搜索（编号不小于
+//			本次线程数的线程直接跳过），结束后计数并继续等待
+// 参	数：int nWorker		线程编号
+// 参	数：int nJob		创建时的搜索序号
+// 返	回：void
+///////////////////////////////////////////////////////////////////
+void ParallelBFS::poolMain(int nWorker, int nJob)
+{
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            while (!m_bQuit && (nJob == m_nJob))
+            {
+                m_wake.wait(lock);
+            }
+            if (m_bQuit)
+            {
+                return;
+            }
+            nJob = m_nJob;
+        }
+        if (nWorker < m_nActive)
+        {
+            workerMain(nWorker);
+        }
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (0 == --m_nRunning)
+        {
+            m_idle.notify_one();
+        }
+    }
+}
+
+///////////////////////////////////////////////////////////////////
+// 函	数：barrier
+// 作	用：同步栅栏，最后到达的线程推进代数放行其他线程。栅栏同时保证
+//			之前的写入对之后的所有线程可见
+// 参	数：void
+// 返	回：void
+///////////////////////////////////////////////////////////////////
+void ParallelBFS::barrier()
+{
+    int nGeneration = m_nGeneration.load(std::memory_order_acquire);
+    if (m_nActive - 1 == m_nArrived.fetch_add(1, std::memory_order_acq_rel))
+    {
+        m_nArrived.store(0, std::memory_order_relaxed);
+        m_nGeneration.fetch_add(1, std::memory_order_release);
+        return;
+    }
+    while (nGeneration == m_nGeneration.load(std::memory_order_acquire))
+    {
+        std::this_thread::yield();
+    }
+}
+
+///////////////////////////////////////////////////////////////////
+// 函	数：workerMain
+// 作	用：线程主流程。0号线程（调用线程）负责串行推进小前沿、选择
+//			处理方式和交换前沿，每个多线程层前后各同步一次
+// 参	数：int nWorker		线程编号
+// 返	回：void
+///////////////////////////////////////////////////////////////////
+void ParallelBFS::workerMain(int nWorker)
+{
+    const MyGrid& grid = *m_pGrid;
+    int nSize = grid.size();
+    int nBegin = (int)((long long)nSize * nWorker / m_nActive);
+    int nEnd = (int)((long long)nSize * (nWorker + 1) / m_nActive);
+    int nPassable = 0;
+
+    // 各线程初始化自己那段格子
+    for (int c = nBegin; c < nEnd; c++)
+    {
+        m_pDist[c].store(INT_MAX, std::memory_order_relaxed);
+        if (grid.isSure(c))
+        {
+            nPassable++;
+        }
+    }
+    m_nPartial[nWorker] = nPassable;
+    barrier();
+    if (0 == nWorker)
+    {
+        m_nPassable = 0;
+        for (int i = 0; i < m_nActive; i++)
+        {
+            m_nPassable += m_nPartial[i];
+        }
+        m_pDist[m_pFrontier[0]].store(0, std::memory_order_relaxed);
+        m_nVisited = 1;
+        m_nMode = BFS_MODE_TOP_DOWN;
+    }
+
+    while (true)
+    {
+        if (0 == nWorker)
+        {
+            // 前沿较小时串行推进，其他线程在栅栏处等待
+            while ((0 < m_nFrontier) && ((1 == m_nActive) || (BFS_PARALLEL_MIN > m_nFrontier)))
+            {
+                serialLevel();
+                m_nMode = BFS_MODE_TOP_DOWN;
+            }
+            if (0 == m_nFrontier)
+            {
+                m_nMode = BFS_MODE_DONE;
+            }
+            else if ((BFS_MODE_TOP_DOWN == m_nMode) && (m_nFrontier > (m_nPassable - m_nVisited) / BFS_ALPHA))
+            {
+                m_nMode = BFS_MODE_BOTTOM_UP;
+            }
+            else if ((BFS_MODE_BOTTOM_UP == m_nMode) && (m_nFrontier < m_nPassable / BFS_BETA))
+            {
+                m_nMode = BFS_MODE_TOP_DOWN;
+            }
+            m_nNextCount.store(0, std::memory_order_relaxed);
+        }
+        barrier();
+        if (BFS_MODE_DONE == m_nMode)
+        {
+            break;
+        }
+        if (BFS_MODE_TOP_DOWN == m_nMode)
+        {
+            topDown(nWorker);
+        }
+        else
+        {
+            bottomUp(nWorker);
+        }
+        barrier();
+        if (0 == nWorker)
+        {
+            int* pSwap = m_pFrontier;
+            m_pFrontier = m_pNext;
+            m_pNext = pSwap;
+            m_nFrontier = m_nNextCount.load(std::memory_order_relaxed);
+            m_nVisited += m_nFrontier;
+            m_nParallelLevels++;
+            if (BFS_MODE_BOTTOM_UP == m_nMode)
+            {
+                m_nBottomUpLevels++;
+            }
+            m_nLevel++;
+        }
+    }
+}
+
+///////////////////////////////////////////////////////////////////
+// 函	数：serialLevel
+// 作	用：调用线程串行推进一层
+// 参	数：void
+// 返	回：void
+///////////////////////////////////////////////////////////////////
+void ParallelBFS::serialLevel()
+{
+    const MyGrid& grid = *m_pGrid;
+    int nCount = 0;
+    for (int i = 0; i < m_nFrontier; i++)
+    {
+        for (int d = 0; d < 4; d++)
+        {
+            int nChild = grid.neighbour(m_pFrontier[i], d);
+            if (grid.isSure(nChild) && (INT_MAX == m_pDist[nChild].load(std::memory_order_relaxed)))
+            {
+                m_pDist[nChild].store(m_nLevel + 1, std::memory_order_relaxed);
+                m_pNext[nCount++] = nChild;
+            }
+        }
+    }
+    int* pSwap = m_pFrontier;
+    m_pFrontier = m_pNext;
+    m_pNext = pSwap;
+    m_nFrontier = nCount;
+    m_nVisited += nCount;
+    m_nLevel++;
+}
+
+///////////////////////////////////////////////////////////////////
+// 函	数：flushLocal
+// 作	用：将线程本地缓冲区整块追加到下一层前沿（一次原子加法占位）
+// 参	数：const int* pnLocal	本地缓冲区
+// 参	数：int nCount		缓冲区中的格子数
+// 返	回：void
+///////////////////////////////////////////////////////////////////
+void ParallelBFS::flushLocal(const int* pnLocal, int nCount)
+{
+    if (0 == nCount)
+    {
+        return;
+    }
+    int nPos = m_nNextCount.fetch_add(nCount, std::memory_order_relaxed);
+    memcpy(m_pNext + nPos, pnLocal, nCount * sizeof(int));
+}
+
+///////////////////////////////////////////////////////////////////
+// 函	数：topDown
+// 作	用：自顶向下推进一层：展开本线程那段前沿，比较交换成功的线程
+//			领取该邻居，保证每个格子只进入一次前沿
+// 参	数：int nWorker		线程编号
+// 返	回：void
+///////////////////////////////////////////////////////////////////
+void ParallelBFS::topDown(int nWorker)
+{
+    const MyGrid& grid = *m_pGrid;
+    int nLocal[BFS_LOCAL_CHUNK];
+    int nCount = 0;
+    int nBegin = (int)((long long)m_nFrontier * nWorker / m_nActive);
+    int nEnd = (int)((long long)m_nFrontier * (nWorker + 1) / m_nActive);
+
+    for (int i = nBegin; i < nEnd; i++)
+    {
+        for (int d = 0; d < 4; d++)
+        {
+            int nChild = grid.neighbour(m_pFrontier[i], d);
+            if (!grid.isSure(nChild) || (INT_MAX != m_pDist[nChild].load(std::memory_order_relaxed)))
+            {
+                continue;
+            }
+            int nExpected = INT_MAX;
+            if (m_pDist[nChild].compare_exchange_strong(nExpected, m_nLevel + 1, std::memory_order_relaxed))
+            {
+                nLocal[nCount++] = nChild;
+                if (BFS_LOCAL_CHUNK == nCount)
+                {
+                    flushLocal(nLocal, nCount);
+                    nCount = 0;
+                }
+            }
+        }
+    }
+    flushLocal(nLocal, nCount);
+}
+
+///////////////////////////////////////////////////////////////////
+// 函	数：bottomUp
+// 作	用：自底向上推进一层：扫描本线程那段格子中未访问的可行格子，
+//			有邻居在当前层即加入下一层。每个格子只由一个线程写入，无需
+//			比较交换
+// 参	数：int nWorker		线程编号
+// 返	回：void
+///////////////////////////////////////////////////////////////////
+void ParallelBFS::bottomUp(int nWorker)
+{
+    const MyGrid& grid = *m_pGrid;
+    int nLocal[BFS_LOCAL_CHUNK];
+    int nCount = 0;
+    int nSize = grid.size();
+    int nBegin = (int)((long long)nSize * nWorker / m_nActive);
+    int nEnd = (int)((long long)nSize * (nWorker + 1) / m_nActive);
+
+    for (int c = nBegin; c < nEnd; c++)
+    {
+        if (!grid.isSure(c) || (INT_MAX != m_pDist[c].load(std::memory_order_relaxed)))
+        {
+            continue;
+        }
+        for (int d = 0; d < 4; d++)
+        {
+            if (m_nLevel == m_pDist[grid.neighbour(c, d)].load(std::memory_order_relaxed))
+            {
+                m_pDist[c].store(m_nLevel + 1, std::memory_order_relaxed);
+                nLocal[nCount++] = c;
+                if (BFS_LOCAL_CHUNK == nCount)
+                {
+                    flushLocal(nLocal, nCount);
+                    nCount = 0;
+                }
+                break;
+            }
+        }
+    }
+    flushLocal(nLocal, nCount);
+}
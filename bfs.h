@@ -0,0 +1,121 @@
+///////////////////////////////////////////////////////////////////
+// 文	件：bfs.h
+// 功	能：基于棋盘存储层（MyGrid）的多线程逐层广度优先搜索（无权地图）
+//			大地图上点数很少时，瓶颈是单次距离扫描而不是点对数量。
+//			每层的前沿由所有线程分片处理：
+//			1）自顶向下：各线程展开自己那段前沿，用原子比较交换领取
+//			未访问的邻居，新前沿先放在线程本地缓冲区，满了再整块追加；
+//			2）自底向上：前沿大到接近未访问格子数时，各线程改为扫描
+//			自己负责的那段未访问格子，检查是否有邻居在当前层。
+//			前沿较小时由调用线程串行推进，避免每层同步的开销。
+//			工作线程首次需要时创建，之后常驻，每次搜索只唤醒一次；
+//			格子数小于BFS_SERIAL_SIZE的地图（约256x256以内，含题干的
+//			100x100以内的地图）只用调用线程，多线程只在更大的棋盘上生效。
+// 作	者：gengjian1203
+// 邮	箱：gengjian1203@foxmail.com
+///////////////////////////////////////////////////////////////////
+#ifndef ORIENTEERING_BFS_H
+#define ORIENTEERING_BFS_H
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include "grid.h"
+
+// 最大线程数
+#define BFS_MAX_THREAD 64
+// 线程本地前沿缓冲区大小
+#define BFS_LOCAL_CHUNK 256
+// 前沿达到该规模才多线程处理
+#define BFS_PARALLEL_MIN 1024
+// 格子数小于该值的地图只用调用线程
+#define BFS_SERIAL_SIZE 65536
+// 方向切换参数：前沿 > 未访问数 / BFS_ALPHA 时转自底向上，
+// 前沿 < 可行格子数 / BFS_BETA 时转回自顶向下
+#define BFS_ALPHA 14
+#define BFS_BETA 24
+
+class ParallelBFS
+{
+public:
+    ParallelBFS();
+    ~ParallelBFS();
+    // 设置线程数（含调用线程，1为单线程）
+    void setThreads(int nThreads);
+    int threads() const { return m_nThreads; }
+    // 上次搜索实际使用的线程数（小地图为1）
+    int activeThreads() const { return m_nActive; }
+    // 预先申请nSize个格子的缓冲区（之后不超过该规模的搜索不再申请内存）
+    bool reserve(int nSize);
+    // 逐层广度优先搜索，计算源点到所有格子的步数
+    bool run(const MyGrid& grid, int nSource);
+    // 源点到格子的步数，不可达为INT_MAX
+    int distance(int nCell) const { return m_pDist[nCell].load(std::memory_order_relaxed); }
+    // 上次搜索的统计信息：总层数、多线程处理的层数、自底向上的层数
+    int levelCount() const { return m_nLevel; }
+    int parallelLevelCount() const { return m_nParallelLevels; }
+    int bottomUpLevelCount() const { return m_nBottomUpLevels; }
+
+private:
+    // 当前搜索的棋盘
+    const MyGrid* m_pGrid;
+    // 各格子到源点的步数（未访问为INT_MAX，同时作为访问标记）
+    std::atomic<int>* m_pDist;
+    // 当前层前沿与下一层前沿
+    int* m_pFrontier;
+    int* m_pNext;
+    int m_nFrontier;
+    std::atomic<int> m_nNextCount;
+    // 当前层号
+    int m_nLevel;
+    // 下一步的处理方式
+    int m_nMode;
+    // 可行格子数、已访问格子数
+    int m_nPassable;
+    int m_nVisited;
+    // 各线程初始化时统计的可行格子数
+    int m_nPartial[BFS_MAX_THREAD];
+    // 设置的线程数、本次搜索实际使用的线程数
+    int m_nThreads;
+    int m_nActive;
+    // 同步栅栏
+    std::atomic<int> m_nArrived;
+    std::atomic<int> m_nGeneration;
+    // 常驻工作线程（1 ~ m_nPoolSize - 1号，0号为调用线程）
+    std::thread m_worker[BFS_MAX_THREAD];
+    int m_nPoolSize;
+    // 唤醒工作线程：搜索序号递增表示有新的搜索，m_nRunning为尚未结束的工作线程数
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_idle;
+    int m_nJob;
+    int m_nRunning;
+    bool m_bQuit;
+    // 统计信息
+    int m_nParallelLevels;
+    int m_nBottomUpLevels;
+    // 已申请的格子数（只增不减，重复使用）
+    int m_nCapacity;
+
+private:
+    // 常驻工作线程：等待唤醒，参与搜索后再次等待
+    void poolMain(int nWorker, int nJob);
+    // 线程主流程（调用线程为0号）
+    void workerMain(int nWorker);
+    // 所有线程到齐后继续
+    void barrier();
+    // 调用线程串行推进一层
+    void serialLevel();
+    // 多线程自顶向下推进一层（本线程负责的部分）
+    void topDown(int nWorker);
+    // 多线程自底向上推进一层（本线程负责的部分）
+    void bottomUp(int nWorker);
+    // 将线程本地缓冲区追加到下一层前沿
+    void flushLocal(const int* pnLocal, int nCount);
+
+    ParallelBFS(const ParallelBFS&);
+    ParallelBFS& operator=(const ParallelBFS&);
+};
+
+#endif
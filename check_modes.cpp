@@ -0,0 +1,1303 @@
+///////////////////////////////////////////////////////////////////
+// 文	件：check_modes.cpp
+// 功	能：求解模式回归检查。以默认设置（完整距离矩阵 + 哈密顿DP）的
+//			solvePath结果为基准，检查其他求解模式在同一张地图上的结果：
+//			1）惰性距离矩阵（各阶段1引擎）须与基准步数相同且路径合法；
+//			2）大点集分簇求解须给出合法路径，步数不超过基准的
+//			CHECK_CLUSTER_GAP%，点数超过CLUSTER_MAX时须确实分成多簇；
+//			另在生成的房间地图上（CHECK_LARGE_POINT个'@'）检查路径
+//			合法且不差于最近邻路径；
+//			3）k条最短路径须与穷举所有访问顺序得到的前KBEST_MAX个步数
+//			一致，第1条等于基准，各路径合法且互不相同；
+//			4）大点集的奖励收集启发式：各预算下路径须合法、不超预算，
+//			分值不超过子集DP的最优分值；
+//			5）各阶段1引擎的完整距离矩阵须与独立的Dijkstra参考矩阵逐项
+//			相同，solvePath步数须等于按参考矩阵穷举访问顺序的最小值；
+//			6）终点任意：solveAllGoals的各终点步数须等于穷举S之后所有
+//			节点（含G）访问顺序、止于该终点的最小值，最佳终点取其最小；
+//			7）A*估价：曼哈顿与ALT两种估价的完整距离矩阵须与基准相同，
+//			ALT估价在无权、带权地图上须可采纳且一致；
+//			8）奖励收集子集DP：在随机小地图上与穷举所有子集及访问顺序
+//			的结果比较，一次调用回答多个预算，覆盖按最大预算剪枝及前沿
+//			二分查找；
+//			9）收缩图：在生成的迷宫地图（死胡同、止于点的通道链、一格宽
+//			的环及自环，无权与带权）上，ENGINE_GRAPH的完整距离矩阵须与
+//			ENGINE_GRID及Dijkstra参考矩阵逐项相同；
+//			10）多线程BFS：在超过BFS_SERIAL_SIZE的无权地图上，经库生成的
+//			矩阵须确实多线程运行且与参考矩阵相同，ParallelBFS与DialSearch
+//			的距离场须逐格相同。
+//			任一检查失败时返回非0
+//	用	法：check_modes [地图1 地图2 ...]（默认为example1~4.txt，
+//			example4.txt为含'2'~'9'的带权地图）
+// 作	者：gengjian1203
+// 邮	箱：gengjian1203@foxmail.com
+///////////////////////////////////////////////////////////////////
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <algorithm>
+#include <functional>
+#include <queue>
+#include <utility>
+#include <vector>
+#include "orienteering.h"
+
+// 分簇求解允许比精确解多出的步数比例（%）
+#define CHECK_CLUSTER_GAP 10
+// 生成的大点集地图的'@'个数
+#define CHECK_LARGE_POINT 300
+// 奖励收集子集DP穷举检查：随机小地图的张数、宽高及'@'个数
+#define CHECK_PRIZE_MAPS 8
+#define CHECK_PRIZE_WIDTH 12
+#define CHECK_PRIZE_HEIGHT 9
+#define CHECK_PRIZE_POINT 8
+// 多线程BFS检查：生成的房间地图边长（格子数须远大于BFS_SERIAL_SIZE）、'@'个数及线程数
+#define CHECK_BFS_SIDE 1024
+#define CHECK_BFS_POINT 8
+#define CHECK_BFS_THREAD 4
+// 生成的迷宫地图：迷宫部分的最大宽高（奇数）、打通的墙数、'@'个数
+#define CHECK_MAZE_MAX 61
+#define CHECK_MAZE_LOOP 12
+#define CHECK_MAZE_POINT 10
+
+///////////////////////////////////////////////////////////////////
+// 函	数：readMapFile
+// 作	用：将地图文件整体读入内存
+// 参	数：const char* pszFile	地图文件名
+// 参	数：size_t* pnLength		输出文件长度
+// 返	回：char*		返回文件内容（由调用者free），失败返回NULL
+///////////////////////////////////////////////////////////////////
+static char* readMapFile(const char* pszFile, size_t* pnLength)
+{
+    FILE* fp = fopen(pszFile, "rb");
+    char* pszText;
+    long nSize;
+    if (NULL == fp)
+    {
+        return NULL;
+    }
+    fseek(fp, 0, SEEK_END);
+    nSize = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    pszText = (char*)malloc(nSize + 1);
+    if (NULL != pszText)
+    {
+        *pnLength = fread(pszText, 1, nSize, fp);
+        pszText[*pnLength] = '\0';
+    }
+    fclose(fp);
+    return pszText;
+}
+
+///////////////////////////////////////////////////////////////////
+// 函	数：prepare
+// 作	用：按指定设置建图并生成距离矩阵
+// 参	数：Orienteering& o		求解上下文
+// 参	数：const char* pszText	地图文本
+// 参	数：size_t nLength		文本长度
+// 参	数：int nEngine		阶段1引擎
+// 参	数：bool bLazy		是否使用惰性距离矩阵
+// 返	回：int		ORIENT_OK或错误码
+///////////////////////////////////////////////////////////////////
+static int prepare(Orienteering& o, const char* pszText, size_t nLength, int nEngine, bool bLazy)
+{
+    int nStatus;
+    o.setEngine(nEngine);
+    o.setLazyMatrix(bLazy);
+    nStatus = o.loadMap(pszText, nLength);
+    return (ORIENT_OK == nStatus) ? o.buildMatrix() : nStatus;
+}
+
+///////////////////////////////////////////////////////////////////
+// 函	数：routeCost
+// 作	用：检查路径是S开头、G结尾、每个点恰好一次的排列，并按基准
+//			距离矩阵计算步数
+// 参	数：const Orienteering& ref	基准上下文（已生成完整距离矩阵）
+// 参	数：const int* pnRoute	节点索引序列
+// 参	数：int nCount		序列长度
+// 返	回：int		路径步数，路径不合法返回-1
+///////////////////////////////////////////////////////////////////
+static int routeCost(const Orienteering& ref, const int* pnRoute, int nCount)
+{
+    bool bSeen[MAX_POINT] = { false };
+    int nCost = 0;
+    if ((ref.pointCount() != nCount) || (0 != pnRoute[0]) || (1 != pnRoute[nCount - 1]))
+    {
+        return -1;
+    }
+    for (int i = 0; i < nCount; i++)
+    {
+        if ((0 > pnRoute[i]) || (nCount <= pnRoute[i]) || bSeen[pnRoute[i]])
+        {
+            return -1;
+        }
+        bSeen[pnRoute[i]] = true;
+        nCost += (0 < i) ? ref.distance(pnRoute[i - 1], pnRoute[i]) : 0;
+    }
+    return nCost;
+}
+
+///////////////////////////////////////////////////////////////////
+// 函	数：referenceMatrix
+// 作	用：不经过库内任何搜索引擎，直接在地图文本上对每个点运行一次
+//			优先队列Dijkstra（进入格子时计入其代价，'.'、'S'、'G'、'@'
+//			为1，数字为其值），得到参考距离矩阵
+// 参	数：const Orienteering& o	已建图的上下文（只读取地图文本和点坐标）
+// 参	数：int nMatrix[][MAX_POINT]	输出距离矩阵（不通为INT_MAX）
+// 返	回：bool		成功返回true，内存不足返回false
+///////////////////////////////////////////////////////////////////
+static bool referenceMatrix(const Orienteering& o, int nMatrix[][MAX_POINT])
+{
+    typedef std::pair<int, int> Item;
+    const int nStepX[4] = { 1, -1, 0, 0 };
+    const int nStepY[4] = { 0, 0, 1, -1 };
+    int nWidth = o.width();
+    int nHeight = o.height();
+    int* pnDist = (int*)malloc((size_t)nWidth * nHeight * sizeof(int));
+    if (NULL == pnDist)
+    {
+        return false;
+    }
+    for (int s = 0; s < o.pointCount(); s++)
+    {
+        std::priority_queue<Item, std::vector<Item>, std::greater<Item> > open;
+        for (int c = 0; c < nWidth * nHeight; c++)
+        {
+            pnDist[c] = INT_MAX;
+        }
+        pnDist[o.point(s).y * nWidth + o.point(s).x] = 0;
+        open.push(Item(0, o.point(s).y * nWidth + o.point(s).x));
+        while (!open.empty())
+        {
+            Item top = open.top();
+            open.pop();
+            if (top.first > pnDist[top.second])
+            {
+                continue;
+            }
+            for (int d = 0; d < 4; d++)
+            {
+                int x = top.second % nWidth + nStepX[d];
+                int y = top.second / nWidth + nStepY[d];
+                if ((0 > x) || (nWidth <= x) || (0 > y) || (nHeight <= y) || ('#' == o.chessRow(y)[x]))
+                {
+                    continue;
+                }
+                char ch = o.chessRow(y)[x];
+                int nCost = top.first + ((('1' <= ch) && ('9' >= ch)) ? (ch - '0') : 1);
+                if (nCost < pnDist[y * nWidth + x])
+                {
+                    pnDist[y * nWidth + x] = nCost;
+                    open.push(Item(nCost, y * nWidth + x));
+                }
+            }
+        }
+        for (int t = 0; t < o.pointCount(); t++)
+        {
+            nMatrix[s][t] = pnDist[o.point(t).y * nWidth + o.point(t).x];
+        }
+    }
+    free(pnDist);
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////
+// 函	数：buildGrid
+// 作	用：按地图文本重新建一个棋盘（不经过上下文内部的棋盘）
+// 参	数：const Orienteering& o	已建图的上下文（只读取地图文本）
+// 参	数：MyGrid& grid		输出棋盘
+// 参	数：int nLayout		存储顺序
+// 返	回：bool		内存申请失败返回false
+///////////////////////////////////////////////////////////////////
+static bool buildGrid(const Orienteering& o, MyGrid& grid, int nLayout)
+{
+    if (!grid.create(o.width(), o.height(), nLayout))
+    {
+        return false;
+    }
+    for (int y = 0; y < o.height(); y++)
+    {
+        for (int x = 0; x < o.width(); x++)
+        {
+            char ch = o.chessRow(y)[x];
+            grid.setCost(x, y, ('#' == ch) ? 0 : ((('1' <= ch) && ('9' >= ch)) ? (ch - '0') : 1));
+        }
+    }
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////
+// 函	数：bruteForcePath
+// 作	用：穷举其余节点的所有访问顺序，求S经过所有节点、终止于指定
+//			终点的最小步数（终点为G时即S经过所有'@'到达G）
+// 参	数：int nMatrix[][MAX_POINT]	距离矩阵
+// 参	数：int n			点数（含S、G）
+// 参	数：int nEnd		终点索引（1 ~ n - 1）
+// 返	回：int		最小步数
+///////////////////////////////////////////////////////////////////
+static int bruteForcePath(int nMatrix[][MAX_POINT], int n, int nEnd)
+{
+    int nOrder[MAX_POINT];
+    int nBest = INT_MAX;
+    int m = 0;
+    for (int k = 1; k < n; k++)
+    {
+        if (nEnd != k)
+        {
+            nOrder[m++] = k;
+        }
+    }
+    do
+    {
+        int nCur = 0;
+        int nCost = 0;
+        for (int i = 0; i < m; i++)
+        {
+            nCost += nMatrix[nCur][nOrder[i]];
+            nCur = nOrder[i];
+        }
+        nBest = std::min(nBest, nCost + nMatrix[nCur][nEnd]);
+    } while (std::next_permutation(nOrder, nOrder + m));
+    return nBest;
+}
+
+///////////////////////////////////////////////////////////////////
+// 函	数：checkEngines
+// 作	用：各阶段1引擎（完整矩阵）的距离矩阵须与Dijkstra参考矩阵逐项
+//			相同，solvePath的步数须等于按参考矩阵穷举的最小值，路径合法。
+//			带权地图上覆盖'2'~'9'的代价及Dial的环形桶回绕
+// 参	数：const Orienteering& ref	基准上下文
+// 参	数：const char* pszFile	地图文件名
+// 参	数：const char* pszText	地图文本
+// 参	数：size_t nLength		文本长度
+// 返	回：int		失败的检查数
+///////////////////////////////////////////////////////////////////
+static int checkEngines(const Orienteering& ref, const char* pszFile, const char* pszText, size_t nLength)
+{
+    const int nEngine[3] = { ENGINE_GRID, ENGINE_GRAPH, ENGINE_BFS };
+    int nMatrix[MAX_POINT][MAX_POINT];
+    int nFailed = 0;
+    int n = ref.pointCount();
+    if (!referenceMatrix(ref, nMatrix))
+    {
+        printf("FAILED dijkstra         %-14s out of memory <--\n", pszFile);
+        return 1;
+    }
+    int nBrute = bruteForcePath(nMatrix, n, 1);
+    Orienteering* pContext = new Orienteering();
+    for (int e = 0; e < 3; e++)
+    {
+        OrientPath path;
+        int nDiffer = 0;
+        int nStatus = prepare(*pContext, pszText, nLength, nEngine[e], false);
+        nStatus = (ORIENT_OK == nStatus) ? pContext->solvePath(&path) : nStatus;
+        for (int i = 0; (ORIENT_OK == nStatus) && (i < n); i++)
+        {
+            for (int j = 0; j < n; j++)
+            {
+                nDiffer += (nMatrix[i][j] != pContext->distance(i, j)) ? 1 : 0;
+            }
+        }
+        bool bOk = (ORIENT_OK == nStatus) && (0 == nDiffer) && (nBrute == path.nSteps)
+            && (nBrute == routeCost(ref, path.nRoute, path.nCount));
+        printf("%-6s dijkstra engine %d  %-14s steps %d / %d  weighted %d  differ %d  %s\n", bOk ? "ok" : "FAILED",
+            nEngine[e], pszFile, (ORIENT_OK == nStatus) ? path.nSteps : -1, nBrute, ref.isWeighted() ? 1 : 0,
+            nDiffer, bOk ? "" : "<--");
+        nFailed += bOk ? 0 : 1;
+    }
+    delete pContext;
+    return nFailed;
+}
+
+///////////////////////////////////////////////////////////////////
+// 函	数：checkAllGoals
+// 作	用：终点任意：对每个终点（G也作为普通节点）穷举其余节点的访问
+//			顺序，solveAllGoals给出的各终点步数须等于穷举的最小值，路径
+//			须为S开头、止于该终点的合法排列；最佳终点的步数须为其中最小
+// 参	数：const Orienteering& ref	基准上下文
+// 参	数：const char* pszFile	地图文件名
+// 参	数：const char* pszText	地图文本
+// 参	数：size_t nLength		文本长度
+// 返	回：int		失败的检查数
+///////////////////////////////////////////////////////////////////
+static int checkAllGoals(const Orienteering& ref, const char* pszFile, const char* pszText, size_t nLength)
+{
+    OrientPath path[MAX_POINT];
+    int nMatrix[MAX_POINT][MAX_POINT];
+    int nMin = INT_MAX;
+    int nBest = -1;
+    int n = ref.pointCount();
+    Orienteering* pContext = new Orienteering();
+    for (int i = 0; i < n; i++)
+    {
+        for (int j = 0; j < n; j++)
+        {
+            nMatrix[i][j] = ref.distance(i, j);
+        }
+    }
+    int nStatus = prepare(*pContext, pszText, nLength, ENGINE_GRID, false);
+    nStatus = (ORIENT_OK == nStatus) ? pContext->solveAllGoals(path, &nBest) : nStatus;
+    bool bOk = (ORIENT_OK == nStatus);
+    for (int k = 1; bOk && (k < n); k++)
+    {
+        bool bSeen[MAX_POINT] = { false };
+        int nBrute = bruteForcePath(nMatrix, n, k);
+        int nCost = 0;
+        nMin = std::min(nMin, nBrute);
+        bOk = (nBrute == path[k].nSteps) && (n == path[k].nCount) && (0 == path[k].nRoute[0])
+            && (k == path[k].nRoute[n - 1]);
+        for (int i = 0; bOk && (i < n); i++)
+        {
+            bOk = (0 <= path[k].nRoute[i]) && (n > path[k].nRoute[i]) && !bSeen[path[k].nRoute[i]];
+            bSeen[path[k].nRoute[i]] = true;
+            nCost += (0 < i) ? nMatrix[path[k].nRoute[i - 1]][path[k].nRoute[i]] : 0;
+        }
+        bOk = bOk && (nCost == nBrute);
+    }
+    bOk = bOk && (0 < nBest) && (n > nBest) && (nMin == path[nBest].nSteps);
+    printf("%-6s any end         %-14s end %d  steps %d / %d  %s\n", bOk ? "ok" : "FAILED", pszFile, nBest,
+        ((0 <= nBest) && (n > nBest)) ? path[nBest].nSteps : -1, nMin, bOk ? "" : "<--");
+    delete pContext;
+    return bOk ? 0 : 1;
+}
+
+///////////////////////////////////////////////////////////////////
+// 函	数：checkHeuristic
+// 作	用：A*估价：
+//			1）分别用HEURISTIC_MANHATTAN与HEURISTIC_ALT生成完整距离矩阵，
+//			两者须与基准逐项相同（库内A*只用于无权地图，带权地图两者
+//			都走Dial）；
+//			2）直接检查ALT估价本身：在地图上选取地标后，以每个点为目标
+//			t，用Dial求出各格子到t的真实代价d(n, t)，每个可行格子n须满足
+//			estimate(n, t) <= d(n, t)（可采纳），且对每个可行邻居m满足
+//			estimate(n, t) <= c(m) + estimate(m, t)（一致）。带权地图上同样
+//			检查，覆盖反向下界中的代价修正项
+// 参	数：const Orienteering& ref	基准上下文
+// 参	数：const char* pszFile	地图文件名
+// 参	数：const char* pszText	地图文本
+// 参	数：size_t nLength		文本长度
+// 返	回：int		失败的检查数
+///////////////////////////////////////////////////////////////////
+static int checkHeuristic(const Orienteering& ref, const char* pszFile, const char* pszText, size_t nLength)
+{
+    const int nMode[2] = { HEURISTIC_MANHATTAN, HEURISTIC_ALT };
+    int nExpand[2] = { -1, -1 };
+    int nDiffer = 0;
+    int nFailed = 0;
+    int n = ref.pointCount();
+    Orienteering* pContext = new Orienteering();
+    bool bOk = true;
+    for (int h = 0; h < 2; h++)
+    {
+        pContext->setHeuristic(nMode[h]);
+        bOk = bOk && (ORIENT_OK == prepare(*pContext, pszText, nLength, ENGINE_GRID, false));
+        for (int i = 0; bOk && (i < n); i++)
+        {
+            for (int j = 0; j < n; j++)
+            {
+                nDiffer += (ref.distance(i, j) != pContext->distance(i, j)) ? 1 : 0;
+            }
+        }
+        nExpand[h] = bOk ? pContext->expandCount() : -1;
+    }
+    bOk = bOk && (0 == nDiffer);
+    printf("%-6s alt     matrix  %-14s weighted %d  differ %d  expanded %d / %d  %s\n", bOk ? "ok" : "FAILED",
+        pszFile, ref.isWeighted() ? 1 : 0, nDiffer, nExpand[1], nExpand[0], bOk ? "" : "<--");
+    nFailed += bOk ? 0 : 1;
+    delete pContext;
+
+    // 直接检查估价：按地图文本重新建棋盘
+    MyGrid grid;
+    DialSearch dial;
+    MyHeuristic heuristic;
+    int nWidth = ref.width();
+    int nHeight = ref.height();
+    int nAdmissible = 0;
+    int nConsistent = 0;
+    int nTighter = 0;
+    bOk = buildGrid(ref, grid, GRID_ROW_MAJOR);
+    bOk = bOk && dial.reserve(grid.size()) && heuristic.reserve(grid.size())
+        && heuristic.prepare(grid, grid.cell(ref.point(0).x, ref.point(0).y), HEURISTIC_ALT, dial)
+        && (0 < heuristic.landmarkCount());
+    for (int t = 0; bOk && (t < n); t++)
+    {
+        MyPoint goal = ref.point(t);
+        int nGoal = grid.cell(goal.x, goal.y);
+        bOk = dial.run(grid, nGoal);
+        for (int y = 0; bOk && (y < nHeight); y++)
+        {
+            for (int x = 0; x < nWidth; x++)
+            {
+                int nCell = grid.cell(x, y);
+                if (!grid.isSure(nCell) || (INT_MAX == dial.distance(nCell)))
+                {
+                    continue;
+                }
+                // 进入格子计代价：d(n, t) = d(t, n) + c(t) - c(n)
+                int nTrue = dial.distance(nCell) + grid.cost(nGoal) - grid.cost(nCell);
+                int nEstimate = heuristic.estimate(x, y, goal.x, goal.y);
+                nAdmissible += (nEstimate > nTrue) ? 1 : 0;
+                nTighter += (nEstimate > abs(goal.x - x) + abs(goal.y - y)) ? 1 : 0;
+                for (int d = 0; d < 4; d++)
+                {
+                    int nNext = grid.neighbour(nCell, d);
+                    int nx = x + ((DIR_RIGHT == d) ? 1 : ((DIR_LEFT == d) ? -1 : 0));
+                    int ny = y + ((DIR_DOWN == d) ? 1 : ((DIR_UP == d) ? -1 : 0));
+                    if (grid.isSure(nNext)
+                        && (nEstimate > grid.cost(nNext) + heuristic.estimate(nx, ny, goal.x, goal.y)))
+                    {
+                        nConsistent++;
+                    }
+                }
+            }
+        }
+    }
+    bOk = bOk && (0 == nAdmissible) && (0 == nConsistent);
+    printf("%-6s alt     bound   %-14s landmarks %d  over %d  inconsistent %d  tighter %d  %s\n",
+        bOk ? "ok" : "FAILED", pszFile, heuristic.landmarkCount(), nAdmissible, nConsistent, nTighter,
+        bOk ? "" : "<--");
+    nFailed += bOk ? 0 : 1;
+    return nFailed;
+}
+
+///////////////////////////////////////////////////////////////////
+// 函	数：checkLazy
+// 作	用：惰性距离矩阵：各引擎下分支定界的结果须与基准步数相同
+// 参	数：const Orienteering& ref	基准上下文
+// 参	数：int nExact		基准步数
+// 参	数：const char* pszFile	地图文件名
+// 参	数：const char* pszText	地图文本
+// 参	数：size_t nLength		文本长度
+// 返	回：int		失败的检查数
+///////////////////////////////////////////////////////////////////
+static int checkLazy(const Orienteering& ref, int nExact, const char* pszFile, const char* pszText, size_t nLength)
+{
+    const int nEngine[3] = { ENGINE_GRID, ENGINE_GRAPH, ENGINE_BFS };
+    int nFailed = 0;
+    Orienteering* pContext = new Orienteering();
+    for (int e = 0; e < 3; e++)
+    {
+        OrientPath path;
+        int nStatus = prepare(*pContext, pszText, nLength, nEngine[e], true);
+        nStatus = (ORIENT_OK == nStatus) ? pContext->solvePath(&path) : nStatus;
+        bool bOk = (ORIENT_OK == nStatus) && (nExact == path.nSteps)
+            && (nExact == routeCost(ref, path.nRoute, path.nCount));
+        printf("%-6s lazy    engine %d  %-14s steps %d / %d  searches %d  %s\n", bOk ? "ok" : "FAILED",
+            nEngine[e], pszFile, (ORIENT_OK == nStatus) ? path.nSteps : -1, nExact,
+            pContext->exactSearchCount(), bOk ? "" : "<--");
+        nFailed += bOk ? 0 : 1;
+    }
+    delete pContext;
+    return nFailed;
+}
+
+///////////////////////////////////////////////////////////////////
+// 函	数：checkCluster
+// 作	用：大点集分簇求解：路径须合法，步数不小于基准且不超过基准的
+//			CHECK_CLUSTER_GAP%；点数超过CLUSTER_MAX时须分成多簇。
+//			两种模式都按扫描顺序为'@'编号，节点索引可以直接对照
+// 参	数：const Orienteering& ref	基准上下文
+// 参	数：int nExact		基准步数
+// 参	数：const char* pszFile	地图文件名
+// 参	数：const char* pszText	地图文本
+// 参	数：size_t nLength		文本长度
+// 返	回：int		失败的检查数
+///////////////////////////////////////////////////////////////////
+static int checkCluster(const Orienteering& ref, int nExact, const char* pszFile, const char* pszText, size_t nLength)
+{
+    int nRoute[MAX_POINT];
+    OrientTour tour;
+    Orienteering* pContext = new Orienteering();
+    tour.pRoute = nRoute;
+    tour.nCapacity = MAX_POINT;
+    tour.nSteps = -1;
+    pContext->setLargeMode(true);
+    int nStatus = prepare(*pContext, pszText, nLength, ENGINE_GRID, false);
+    nStatus = (ORIENT_OK == nStatus) ? pContext->solveTour(&tour) : nStatus;
+    bool bOk = (ORIENT_OK == nStatus) && (ref.pointCount() == pContext->largePointCount());
+    for (int k = 0; bOk && (k < ref.pointCount()); k++)
+    {
+        bOk = (ref.point(k).x == pContext->largePoint(k).x) && (ref.point(k).y == pContext->largePoint(k).y);
+    }
+    bOk = bOk && (tour.nSteps == routeCost(ref, tour.pRoute, tour.nCount)) && (nExact <= tour.nSteps)
+        && (tour.nSteps * 100 <= nExact * (100 + CHECK_CLUSTER_GAP))
+        && ((CLUSTER_MAX >= ref.pointCount()) || (1 < pContext->clusterCount()));
+    printf("%-6s cluster         %-14s steps %d / %d  clusters %d  %s\n", bOk ? "ok" : "FAILED", pszFile,
+        tour.nSteps, nExact, pContext->clusterCount(), bOk ? "" : "<--");
+    delete pContext;
+    return bOk ? 0 : 1;
+}
+
+///////////////////////////////////////////////////////////////////
+// 函	数：generateRoomMap
+// 作	用：生成nSide x nSide的房间地图：每隔20格一道墙，相邻房间之间各开
+//			一扇门（保证连通），再在空地上随机放置S、G和nPoints个'@'
+// 参	数：char* pszText		输出地图文本（至少16 + nSide * (nSide + 1)个字符）
+// 参	数：int nSide		地图边长
+// 参	数：int nPoints		'@'个数
+// 返	回：size_t		文本长度
+///////////////////////////////////////////////////////////////////
+static size_t generateRoomMap(char* pszText, int nSide, int nPoints)
+{
+    char* pRow = pszText + sprintf(pszText, "%d,%d\n", nSide, nSide);
+    // 固定种子，每次生成同一张地图
+    srand(20141020);
+    for (int y = 0; y < nSide; y++)
+    {
+        for (int x = 0; x < nSide; x++)
+        {
+            pRow[y * (nSide + 1) + x] = ((0 != x % 20) && (0 != y % 20)) || (0 == x) || (0 == y) ? '.' : '#';
+        }
+        pRow[y * (nSide + 1) + nSide] = '\n';
+    }
+    for (int k = 20; k < nSide; k += 20)
+    {
+        for (int r = 0; r < nSide; r += 20)
+        {
+            pRow[(r + 1 + rand() % 19) * (nSide + 1) + k] = '.';
+            pRow[k * (nSide + 1) + r + 1 + rand() % 19] = '.';
+        }
+    }
+    for (int k = 0; k < nPoints + 2; )
+    {
+        char* pCell = &pRow[(rand() % nSide) * (nSide + 1) + rand() % nSide];
+        if ('.' == *pCell)
+        {
+            *pCell = (0 == k) ? 'S' : ((1 == k) ? 'G' : '@');
+            k++;
+        }
+    }
+    return (pRow - pszText) + nSide * (nSide + 1);
+}
+
+///////////////////////////////////////////////////////////////////
+// 函	数：checkLargeMap
+// 作	用：在生成的房间地图上检查分簇求解：路径须为合法排列，步数与
+//			按距离矩阵重新计算的一致，且不差于最近邻路径
+// 参	数：void
+// 返	回：int		失败的检查数
+///////////////////////////////////////////////////////////////////
+static int checkLargeMap()
+{
+    static char szText[16 + 100 * 101];
+    static int nRoute[MAX_LARGE_POINT];
+    static bool bSeen[MAX_LARGE_POINT];
+    OrientTour tour;
+    int nNearest = 0;
+    int nCost = 0;
+    size_t nLength = generateRoomMap(szText, 100, CHECK_LARGE_POINT);
+    Orienteering* pContext = new Orienteering();
+    Orienteering& o = *pContext;
+    tour.pRoute = nRoute;
+    tour.nCapacity = MAX_LARGE_POINT;
+    o.setLargeMode(true);
+    int nStatus = prepare(o, szText, nLength, ENGINE_GRID, false);
+    nStatus = (ORIENT_OK == nStatus) ? o.solveTour(&tour) : nStatus;
+    int n = (ORIENT_OK == nStatus) ? o.largePointCount() : 0;
+    bool bOk = (ORIENT_OK == nStatus) && (CHECK_LARGE_POINT + 2 == n) && (n == tour.nCount)
+        && (0 == nRoute[0]) && (1 == nRoute[n - 1]) && (1 < o.clusterCount());
+
+    // 合法排列及步数
+    for (int i = 0; i < n; i++)
+    {
+        bSeen[i] = false;
+    }
+    for (int i = 0; bOk && (i < n); i++)
+    {
+        bOk = (0 <= nRoute[i]) && (n > nRoute[i]) && !bSeen[nRoute[i]];
+        bSeen[nRoute[i]] = true;
+        nCost += (0 < i) ? o.largeDistance(nRoute[i - 1], nRoute[i]) : 0;
+    }
+    bOk = bOk && (nCost == tour.nSteps);
+
+    // 最近邻路径：从S出发每次走向最近的未访问'@'，最后到G
+    if (bOk)
+    {
+        int nCur = 0;
+        for (int i = 0; i < n; i++)
+        {
+            bSeen[i] = (2 > i);
+        }
+        for (int i = 2; i < n; i++)
+        {
+            int nBest = -1;
+            for (int k = 2; k < n; k++)
+            {
+                if (!bSeen[k] && ((-1 == nBest) || (o.largeDistance(nCur, k) < o.largeDistance(nCur, nBest))))
+                {
+                    nBest = k;
+                }
+            }
+            nNearest += o.largeDistance(nCur, nBest);
+            bSeen[nBest] = true;
+            nCur = nBest;
+        }
+        nNearest += o.largeDistance(nCur, 1);
+        bOk = (tour.nSteps <= nNearest);
+    }
+    printf("%-6s cluster         generated %d  steps %d  nearest-neighbour %d  clusters %d  %s\n",
+        bOk ? "ok" : "FAILED", CHECK_LARGE_POINT, tour.nSteps, nNearest, o.clusterCount(), bOk ? "" : "<--");
+    delete pContext;
+    return bOk ? 0 : 1;
+}
+
+///////////////////////////////////////////////////////////////////
+// 函	数：checkKBest
+// 作	用：k条最短路径：穷举所有'@'的访问顺序，保留最小的KBEST_MAX个
+//			步数，与solveKBest的结果逐条比较；各路径须合法、步数与按
+//			基准矩阵重新计算的一致，且访问顺序互不相同
+// 参	数：const Orienteering& ref	基准上下文
+// 参	数：int nExact		基准步数
+// 参	数：const char* pszFile	地图文件名
+// 参	数：const char* pszText	地图文本
+// 参	数：size_t nLength		文本长度
+// 返	回：int		失败的检查数
+///////////////////////////////////////////////////////////////////
+static int checkKBest(const Orienteering& ref, int nExact, const char* pszFile, const char* pszText, size_t nLength)
+{
+    OrientPath path[KBEST_MAX];
+    int nBest[KBEST_MAX];
+    int nOrder[MAX_POINT];
+    int nFound = 0;
+    int nCount = 0;
+    int n = ref.pointCount();
+    Orienteering* pContext = new Orienteering();
+
+    // 穷举：S、各'@'的一个排列、G，插入排序保留最小的KBEST_MAX个步数
+    for (int i = 0; i < n - 2; i++)
+    {
+        nOrder[i] = i + 2;
+    }
+    do
+    {
+        int nCost = ref.distance(0, (2 < n) ? nOrder[0] : 1);
+        for (int i = 0; i + 1 < n - 2; i++)
+        {
+            nCost += ref.distance(nOrder[i], nOrder[i + 1]);
+        }
+        nCost += (2 < n) ? ref.distance(nOrder[n - 3], 1) : 0;
+        if ((KBEST_MAX > nFound) || (nCost < nBest[KBEST_MAX - 1]))
+        {
+            int p = (KBEST_MAX > nFound) ? nFound++ : (KBEST_MAX - 1);
+            while ((0 < p) && (nBest[p - 1] > nCost))
+            {
+                nBest[p] = nBest[p - 1];
+                p--;
+            }
+            nBest[p] = nCost;
+        }
+    } while (std::next_permutation(nOrder, nOrder + n - 2));
+
+    int nStatus = prepare(*pContext, pszText, nLength, ENGINE_GRID, false);
+    nStatus = (ORIENT_OK == nStatus) ? pContext->solveKBest(KBEST_MAX, path, &nCount) : nStatus;
+    bool bOk = (ORIENT_OK == nStatus) && (nFound == nCount) && (nExact == path[0].nSteps);
+    for (int r = 0; bOk && (r < nCount); r++)
+    {
+        bOk = (nBest[r] == path[r].nSteps) && (path[r].nSteps == routeCost(ref, path[r].nRoute, path[r].nCount));
+        for (int q = 0; bOk && (q < r); q++)
+        {
+            bOk = (0 != memcmp(path[q].nRoute, path[r].nRoute, n * sizeof(int)));
+        }
+    }
+    printf("%-6s k-best          %-14s routes %d / %d  worst %d  table %lu bytes  %s\n", bOk ? "ok" : "FAILED",
+        pszFile, nCount, nFound, (0 < nCount) ? path[nCount - 1].nSteps : -1,
+        (unsigned long)pContext->kBestMemory(), bOk ? "" : "<--");
+    delete pContext;
+    return bOk ? 0 : 1;
+}
+
+///////////////////////////////////////////////////////////////////
+// 函	数：checkPrize
+// 作	用：大点集的奖励收集启发式：预算取S->G最短距离之下一档及其与
+//			基准步数之间的若干档，与子集DP（精确解）比较。路径须为S开头、
+//			G结尾、点不重复的序列，步数不超预算且与重新计算的一致，
+//			分值不超过精确解；S->G都到不了的预算须与精确解一样返回-1
+// 参	数：Orienteering& ref		基准上下文（solvePrize会改写其DP表）
+// 参	数：int nExact		基准步数
+// 参	数：const char* pszFile	地图文件名
+// 参	数：const char* pszText	地图文本
+// 参	数：size_t nLength		文本长度
+// 返	回：int		失败的检查数
+///////////////////////////////////////////////////////////////////
+static int checkPrize(Orienteering& ref, int nExact, const char* pszFile, const char* pszText, size_t nLength)
+{
+    const int nSteps = 4;
+    int nBudget[nSteps + 2];
+    OrientPrize prize[nSteps + 2];
+    int nRoute[MAX_POINT];
+    OrientTour tour;
+    int nDirect = ref.distance(0, 1);
+    int nFailed = 0;
+    Orienteering* pContext = new Orienteering();
+
+    nBudget[0] = nDirect - 1;
+    for (int t = 0; t <= nSteps; t++)
+    {
+        nBudget[t + 1] = nDirect + (nExact - nDirect) * t / nSteps;
+    }
+    tour.pRoute = nRoute;
+    tour.nCapacity = MAX_POINT;
+    pContext->setLargeMode(true);
+    bool bOk = (ORIENT_OK == ref.solvePrize(nBudget, nSteps + 2, prize))
+        && (ORIENT_OK == prepare(*pContext, pszText, nLength, ENGINE_GRID, false));
+    for (int b = 0; bOk && (b < nSteps + 2); b++)
+    {
+        bool bSeen[MAX_POINT] = { false };
+        int nScore = -1;
+        int nCost = 0;
+        bOk = (ORIENT_OK == pContext->solvePrizeTour(nBudget[b], &tour, &nScore))
+            && ((-1 == nScore) == (-1 == prize[b].nScore)) && (nScore <= prize[b].nScore);
+        if (!bOk)
+        {
+            continue;
+        }
+        bOk = (-1 == nScore) || ((2 <= tour.nCount) && (0 == nRoute[0]) && (1 == nRoute[tour.nCount - 1]));
+        for (int i = 0; bOk && (i < tour.nCount); i++)
+        {
+            bOk = (0 <= nRoute[i]) && (ref.pointCount() > nRoute[i]) && !bSeen[nRoute[i]];
+            bSeen[nRoute[i]] = true;
+            nCost += (0 < i) ? ref.distance(nRoute[i - 1], nRoute[i]) : 0;
+        }
+        bOk = bOk && ((-1 == nScore) || ((nCost == tour.nSteps) && (nCost <= nBudget[b])));
+        printf("%-6s prize           %-14s budget %d  score %d / %d  %s\n", bOk ? "ok" : "FAILED", pszFile,
+            nBudget[b], nScore, prize[b].nScore, bOk ? "" : "<--");
+        nFailed += bOk ? 0 : 1;
+    }
+    if (!bOk)
+    {
+        printf("FAILED prize           %-14s <--\n", pszFile);
+        nFailed++;
+    }
+    delete pContext;
+    return nFailed;
+}
+
+///////////////////////////////////////////////////////////////////
+// 函	数：generatePrizeMap
+// 作	用：生成CHECK_PRIZE_WIDTH x CHECK_PRIZE_HEIGHT的随机小地图：约1/5
+//			为墙，约1/10为代价'2'~'5'的慢行格，随机放置S、G和
+//			CHECK_PRIZE_POINT个'@'；约一半的'@'在地图之后用“x,y,分值”行
+//			指定1~9分，其余默认1分（不保证连通，由调用者判断）
+// 参	数：char* pszText		输出地图文本
+// 参	数：int* pnScore		输出各格子的分值（行优先，非'@'为0）
+// 返	回：size_t		文本长度
+///////////////////////////////////////////////////////////////////
+static size_t generatePrizeMap(char* pszText, int* pnScore)
+{
+    const int nWidth = CHECK_PRIZE_WIDTH;
+    const int nHeight = CHECK_PRIZE_HEIGHT;
+    char* pRow = pszText + sprintf(pszText, "%d,%d\n", nWidth, nHeight);
+    char* p = pRow + nHeight * (nWidth + 1);
+    for (int y = 0; y < nHeight; y++)
+    {
+        for (int x = 0; x < nWidth; x++)
+        {
+            int r = rand() % 10;
+            pRow[y * (nWidth + 1) + x] = (2 > r) ? '#' : ((2 == r) ? (char)('2' + rand() % 4) : '.');
+            pnScore[y * nWidth + x] = 0;
+        }
+        pRow[y * (nWidth + 1) + nWidth] = '\n';
+    }
+    for (int k = 0; k < CHECK_PRIZE_POINT + 2; )
+    {
+        int x = rand() % nWidth;
+        int y = rand() % nHeight;
+        char* pCell = &pRow[y * (nWidth + 1) + x];
+        if (('#' == *pCell) || ('S' == *pCell) || ('G' == *pCell) || ('@' == *pCell))
+        {
+            continue;
+        }
+        *pCell = (0 == k) ? 'S' : ((1 == k) ? 'G' : '@');
+        if (2 <= k)
+        {
+            pnScore[y * nWidth + x] = 1;
+            if (0 == rand() % 2)
+            {
+                pnScore[y * nWidth + x] = 1 + rand() % 9;
+                p += sprintf(p, "%d,%d,%d\n", x, y, pnScore[y * nWidth + x]);
+            }
+        }
+        k++;
+    }
+    return p - pszText;
+}
+
+///////////////////////////////////////////////////////////////////
+// 函	数：checkPrizeDP
+// 作	用：奖励收集子集DP：在随机小地图上穷举'@'的所有子集及其访问
+//			顺序，求出每个子集S->子集->G的最少步数；对每个预算，最优分值
+//			为步数不超预算的子集中的最大分值，实际步数为取得该分值的
+//			子集中的最少步数。一次solvePrize传入一组乱序预算（含S->G
+//			都到不了的、恰好等于某子集步数的、超过全部'@'的），另用只到
+//			中间档的一组预算再调用一次，使最大预算以内的状态也被剪枝；
+//			各预算的分值、步数须与穷举一致，路径须合法且分值、步数与
+//			重新计算的一致
+// 参	数：void
+// 返	回：int		失败的检查数
+///////////////////////////////////////////////////////////////////
+static int checkPrizeDP()
+{
+    const int nSubsets = 1 << CHECK_PRIZE_POINT;
+    static char szText[16 + CHECK_PRIZE_HEIGHT * (CHECK_PRIZE_WIDTH + 1) + CHECK_PRIZE_POINT * 16];
+    static int nCellScore[CHECK_PRIZE_WIDTH * CHECK_PRIZE_HEIGHT];
+    static int nSubsetCost[1 << CHECK_PRIZE_POINT];
+    static int nSubsetScore[1 << CHECK_PRIZE_POINT];
+    int nMatrix[MAX_POINT][MAX_POINT];
+    int nFailed = 0;
+    int nMaps = 0;
+    Orienteering* pContext = new Orienteering();
+    Orienteering& o = *pContext;
+
+    // 固定种子，每次生成同一组地图；不连通的地图跳过
+    srand(20141021);
+    while (nMaps < CHECK_PRIZE_MAPS)
+    {
+        size_t nLength = generatePrizeMap(szText, nCellScore);
+        if ((ORIENT_OK != prepare(o, szText, nLength, ENGINE_GRID, false)) || !referenceMatrix(o, nMatrix))
+        {
+            continue;
+        }
+        nMaps++;
+
+        // 穷举每个子集的最少步数及其分值（子集第b位为节点b + 2）
+        for (int m = 0; m < nSubsets; m++)
+        {
+            int nOrder[CHECK_PRIZE_POINT];
+            int nCount = 0;
+            nSubsetScore[m] = 0;
+            nSubsetCost[m] = INT_MAX;
+            for (int b = 0; b < CHECK_PRIZE_POINT; b++)
+            {
+                if (m & (1 << b))
+                {
+                    MyPoint point = o.point(b + 2);
+                    nOrder[nCount++] = b + 2;
+                    nSubsetScore[m] += nCellScore[point.y * CHECK_PRIZE_WIDTH + point.x];
+                }
+            }
+            do
+            {
+                int nCur = 0;
+                int nCost = 0;
+                for (int i = 0; i < nCount; i++)
+                {
+                    nCost += nMatrix[nCur][nOrder[i]];
+                    nCur = nOrder[i];
+                }
+                nSubsetCost[m] = std::min(nSubsetCost[m], nCost + nMatrix[nCur][1]);
+            } while (std::next_permutation(nOrder, nOrder + nCount));
+        }
+
+        // 预算：S->G之下一档、S->G、两个子集的步数、中间若干档、全部'@'之上
+        int nDirect = nSubsetCost[0];
+        int nAll = nSubsetCost[nSubsets - 1];
+        int nBudget[8] = { nAll + 5, nDirect - 1, (nDirect + nAll) / 2, nSubsetCost[1], nDirect,
+            nSubsetCost[nSubsets / 2 + 1], nDirect + (nAll - nDirect) / 4, nAll };
+        int nCalls[2] = { 8, 0 };
+        int nPart[8];
+        for (int b = 0; b < 8; b++)
+        {
+            if (nBudget[b] <= (nDirect + nAll) / 2)
+            {
+                nPart[nCalls[1]++] = nBudget[b];
+            }
+        }
+        for (int c = 0; c < 2; c++)
+        {
+            OrientPrize prize[8];
+            const int* pnBudget = (0 == c) ? nBudget : nPart;
+            int nBad = 0;
+            bool bOk = (ORIENT_OK == o.solvePrize(pnBudget, nCalls[c], prize));
+            for (int b = 0; bOk && (b < nCalls[c]); b++)
+            {
+                bool bSeen[MAX_POINT] = { false };
+                int nBest = -1;
+                int nSteps = -1;
+                int nScore = 0;
+                int nCost = 0;
+                for (int m = 0; m < nSubsets; m++)
+                {
+                    if ((nSubsetCost[m] <= pnBudget[b]) && ((nSubsetScore[m] > nBest)
+                        || ((nSubsetScore[m] == nBest) && (nSubsetCost[m] < nSteps))))
+                    {
+                        nBest = nSubsetScore[m];
+                        nSteps = nSubsetCost[m];
+                    }
+                }
+                bool bRight = (nBest == prize[b].nScore) && (nSteps == prize[b].nSteps);
+                if (bRight && (-1 != nBest))
+                {
+                    bRight = (2 <= prize[b].nCount) && (0 == prize[b].nRoute[0])
+                        && (1 == prize[b].nRoute[prize[b].nCount - 1]);
+                    for (int i = 0; bRight && (i < prize[b].nCount); i++)
+                    {
+                        int k = prize[b].nRoute[i];
+                        bRight = (0 <= k) && (o.pointCount() > k) && !bSeen[k];
+                        bSeen[k] = true;
+                        nCost += (0 < i) ? nMatrix[prize[b].nRoute[i - 1]][k] : 0;
+                        nScore += (bRight && (2 <= k)) ? nCellScore[o.point(k).y * CHECK_PRIZE_WIDTH + o.point(k).x] : 0;
+                    }
+                    bRight = bRight && (nCost == nSteps) && (nScore == nBest);
+                }
+                nBad += bRight ? 0 : 1;
+            }
+            bOk = bOk && (0 == nBad);
+            printf("%-6s prize   dp      generated %d  budgets %d  max %d  direct %d  all %d  wrong %d  %s\n",
+                bOk ? "ok" : "FAILED", nMaps, nCalls[c], (0 == c) ? nAll + 5 : (nDirect + nAll) / 2, nDirect, nAll,
+                nBad, bOk ? "" : "<--");
+            nFailed += bOk ? 0 : 1;
+        }
+    }
+    delete pContext;
+    return nFailed;
+}
+
+///////////////////////////////////////////////////////////////////
+// 函	数：generateMazeMap
+// 作	用：生成通道为主的迷宫地图：
+//			1）在奇数坐标的格子上用随机深度优先搜索挖出一格宽的完美迷宫
+//			（大量死胡同和一格宽的通道链）；
+//			2）随机打通CHECK_MAZE_LOOP面隔墙，形成一格宽的环；
+//			3）迷宫右侧各挂一个3x3的环形通道（只经一个路口连到迷宫），
+//			其中一个环上放'@'，另一个不放点，收缩后分别成为重边和自环；
+//			4）S及一半的'@'放在死胡同末端，其余'@'和G放在通道上；
+//			5）带权时约1/6的空地改为代价'2'~'9'的慢行格。
+//			生成的地图总是连通的
+// 参	数：char* pszText		输出地图文本
+// 参	数：int nMazeWidth		迷宫部分的宽（奇数，不超过CHECK_MAZE_MAX）
+// 参	数：int nMazeHeight		迷宫部分的高（奇数，不小于11）
+// 参	数：bool bWeighted		是否生成慢行格
+// 参	数：int* pnDeadEnd		输出放在死胡同末端的点数（含S）
+// 参	数：int* pnChain		输出放在可行邻居恰为2的通道格上的点数
+// 返	回：size_t		文本长度
+///////////////////////////////////////////////////////////////////
+static size_t generateMazeMap(char* pszText, int nMazeWidth, int nMazeHeight, bool bWeighted,
+    int* pnDeadEnd, int* pnChain)
+{
+    static char szMaze[CHECK_MAZE_MAX][CHECK_MAZE_MAX + 4];
+    static int nStack[CHECK_MAZE_MAX * CHECK_MAZE_MAX];
+    const int nStepX[4] = { 1, -1, 0, 0 };
+    const int nStepY[4] = { 0, 0, 1, -1 };
+    int nWidth = nMazeWidth + 4;
+    int nHeight = nMazeHeight;
+    int nTop = 0;
+
+    for (int y = 0; y < nHeight; y++)
+    {
+        memset(szMaze[y], '#', nWidth);
+    }
+    // 1）随机深度优先搜索挖迷宫
+    szMaze[1][1] = '.';
+    nStack[nTop++] = 1 * nWidth + 1;
+    while (0 < nTop)
+    {
+        int x = nStack[nTop - 1] % nWidth;
+        int y = nStack[nTop - 1] / nWidth;
+        int nDir[4];
+        int nCount = 0;
+        for (int d = 0; d < 4; d++)
+        {
+            int nx = x + 2 * nStepX[d];
+            int ny = y + 2 * nStepY[d];
+            if ((0 < nx) && (nMazeWidth - 1 > nx) && (0 < ny) && (nHeight - 1 > ny) && ('#' == szMaze[ny][nx]))
+            {
+                nDir[nCount++] = d;
+            }
+        }
+        if (0 == nCount)
+        {
+            nTop--;
+            continue;
+        }
+        int d = nDir[rand() % nCount];
+        szMaze[y + nStepY[d]][x + nStepX[d]] = '.';
+        szMaze[y + 2 * nStepY[d]][x + 2 * nStepX[d]] = '.';
+        nStack[nTop++] = (y + 2 * nStepY[d]) * nWidth + x + 2 * nStepX[d];
+    }
+    // 2）打通隔墙（两侧都是通道的墙）形成环
+    for (int k = 0; k < CHECK_MAZE_LOOP; )
+    {
+        int x = 1 + rand() % (nMazeWidth - 2);
+        int y = 1 + rand() % (nHeight - 2);
+        bool bRow = ('.' == szMaze[y][x - 1]) && ('.' == szMaze[y][x + 1]) && ('#' == szMaze[y - 1][x]) && ('#' == szMaze[y + 1][x]);
+        bool bColumn = ('.' == szMaze[y - 1][x]) && ('.' == szMaze[y + 1][x]) && ('#' == szMaze[y][x - 1]) && ('#' == szMaze[y][x + 1]);
+        if (('#' == szMaze[y][x]) && (bRow || bColumn))
+        {
+            szMaze[y][x] = '.';
+            k++;
+        }
+    }
+    // 3）右侧的两个环：经(nMazeWidth - 1, y0 + 1)连到迷宫格(nMazeWidth - 2, y0 + 1)
+    for (int r = 0; r < 2; r++)
+    {
+        int y0 = 2 + r * 6;
+        szMaze[y0 + 1][nMazeWidth - 1] = '.';
+        for (int y = y0; y <= y0 + 2; y++)
+        {
+            for (int x = nMazeWidth; x <= nMazeWidth + 2; x++)
+            {
+                szMaze[y][x] = ((y0 + 1 == y) && (nMazeWidth + 1 == x)) ? '#' : '.';
+            }
+        }
+    }
+    szMaze[9][nMazeWidth + 2] = '@';
+
+    // 4）放点：先找出死胡同末端
+    int nPlaced = 1;
+    *pnDeadEnd = 0;
+    for (int nTry = 0; nPlaced < CHECK_MAZE_POINT + 2; nTry++)
+    {
+        int x = rand() % nWidth;
+        int y = rand() % nHeight;
+        int nDegree = 0;
+        if ('.' != szMaze[y][x])
+        {
+            continue;
+        }
+        for (int d = 0; d < 4; d++)
+        {
+            int nx = x + nStepX[d];
+            int ny = y + nStepY[d];
+            nDegree += ((0 <= nx) && (nWidth > nx) && (0 <= ny) && (nHeight > ny) && ('#' != szMaze[ny][nx])) ? 1 : 0;
+        }
+        // 前半段只接受死胡同末端（S最先放）；尝试次数过多时不再限制
+        bool bDeadEndWanted = (nPlaced <= CHECK_MAZE_POINT / 2) && (nTry < 100000);
+        if (bDeadEndWanted && (1 != nDegree))
+        {
+            continue;
+        }
+        *pnDeadEnd += (1 == nDegree) ? 1 : 0;
+        szMaze[y][x] = (1 == nPlaced) ? 'S' : ((CHECK_MAZE_POINT + 1 == nPlaced) ? 'G' : '@');
+        nPlaced++;
+    }
+    // 5）慢行格
+    for (int y = 0; bWeighted && (y < nHeight); y++)
+    {
+        for (int x = 0; x < nWidth; x++)
+        {
+            if (('.' == szMaze[y][x]) && (0 == rand() % 6))
+            {
+                szMaze[y][x] = (char)('2' + rand() % 8);
+            }
+        }
+    }
+
+    // 统计放在通道链上的点
+    *pnChain = 0;
+    char* p = pszText + sprintf(pszText, "%d,%d\n", nWidth, nHeight);
+    for (int y = 0; y < nHeight; y++)
+    {
+        for (int x = 0; x < nWidth; x++)
+        {
+            int nDegree = 0;
+            for (int d = 0; d < 4; d++)
+            {
+                int nx = x + nStepX[d];
+                int ny = y + nStepY[d];
+                nDegree += ((0 <= nx) && (nWidth > nx) && (0 <= ny) && (nHeight > ny) && ('#' != szMaze[ny][nx])) ? 1 : 0;
+            }
+            *pnChain += (('S' == szMaze[y][x]) || ('G' == szMaze[y][x]) || ('@' == szMaze[y][x])) && (2 == nDegree) ? 1 : 0;
+            *p++ = szMaze[y][x];
+        }
+        *p++ = '\n';
+    }
+    return p - pszText;
+}
+
+///////////////////////////////////////////////////////////////////
+// 函	数：checkMazeGraph
+// 作	用：在生成的迷宫地图（无权、带权各两张）上，ENGINE_GRAPH的完整
+//			距离矩阵须与ENGINE_GRID逐项相同，且都与Dijkstra参考矩阵相同
+// 参	数：void
+// 返	回：int		失败的检查数
+///////////////////////////////////////////////////////////////////
+static int checkMazeGraph()
+{
+    static char szText[16 + CHECK_MAZE_MAX * (CHECK_MAZE_MAX + 5)];
+    const int nSize[4][2] = { { 31, 21 }, { 31, 21 }, { CHECK_MAZE_MAX, 45 }, { CHECK_MAZE_MAX, 45 } };
+    int nMatrix[MAX_POINT][MAX_POINT];
+    int nFailed = 0;
+    Orienteering* pGrid = new Orienteering();
+    Orienteering* pGraph = new Orienteering();
+
+    // 固定种子，每次生成同一组地图
+    srand(20141022);
+    for (int m = 0; m < 4; m++)
+    {
+        int nDeadEnd = 0;
+        int nChain = 0;
+        int nDiffer = 0;
+        bool bWeighted = (1 == m % 2);
+        size_t nLength = generateMazeMap(szText, nSize[m][0], nSize[m][1], bWeighted, &nDeadEnd, &nChain);
+        bool bOk = (ORIENT_OK == prepare(*pGrid, szText, nLength, ENGINE_GRID, false))
+            && (ORIENT_OK == prepare(*pGraph, szText, nLength, ENGINE_GRAPH, false))
+            && referenceMatrix(*pGrid, nMatrix) && (bWeighted == pGrid->isWeighted());
+        for (int i = 0; bOk && (i < pGrid->pointCount()); i++)
+        {
+            for (int j = 0; j < pGrid->pointCount(); j++)
+            {
+                nDiffer += ((pGrid->distance(i, j) != pGraph->distance(i, j)) || (nMatrix[i][j] != pGrid->distance(i, j))) ? 1 : 0;
+            }
+        }
+        bOk = bOk && (0 == nDiffer);
+        printf("%-6s graph   maze    %dx%d  weighted %d  dead-end points %d  chain points %d  nodes %d  differ %d  %s\n",
+            bOk ? "ok" : "FAILED", nSize[m][0] + 4, nSize[m][1], bWeighted ? 1 : 0, nDeadEnd, nChain,
+            pGraph->graph().nodeCount(), nDiffer, bOk ? "" : "<--");
+        nFailed += bOk ? 0 : 1;
+    }
+    delete pGrid;
+    delete pGraph;
+    return nFailed;
+}
+
+///////////////////////////////////////////////////////////////////
+// 函	数：generateOpenMap
+// 作	用：生成nSide x nSide的空旷地图：约1/10的格子为零散的墙，在中间
+//			一半的区域内随机放置S、G和nPoints个'@'，各点四周清为空地。
+//			从任一点出发前沿都能扩大到BFS_PARALLEL_MIN以上，多线程BFS
+//			会真正多线程推进
+// 参	数：char* pszText		输出地图文本（至少16 + nSide * (nSide + 1)个字符）
+// 参	数：int nSide		地图边长
+// 参	数：int nPoints		'@'个数
+// 返	回：size_t		文本长度
+///////////////////////////////////////////////////////////////////
+static size_t generateOpenMap(char* pszText, int nSide, int nPoints)
+{
+    char* pRow = pszText + sprintf(pszText, "%d,%d\n", nSide, nSide);
+    // 固定种子，每次生成同一张地图
+    srand(20141023);
+    for (int y = 0; y < nSide; y++)
+    {
+        for (int x = 0; x < nSide; x++)
+        {
+            pRow[y * (nSide + 1) + x] = (0 == rand() % 10) ? '#' : '.';
+        }
+        pRow[y * (nSide + 1) + nSide] = '\n';
+    }
+    for (int k = 0; k < nPoints + 2; )
+    {
+        int x = nSide / 4 + rand() % (nSide / 2);
+        int y = nSide / 4 + rand() % (nSide / 2);
+        if ('.' == pRow[y * (nSide + 1) + x])
+        {
+            pRow[y * (nSide + 1) + x] = (0 == k) ? 'S' : ((1 == k) ? 'G' : '@');
+            pRow[(y - 1) * (nSide + 1) + x] = ('#' == pRow[(y - 1) * (nSide + 1) + x]) ? '.' : pRow[(y - 1) * (nSide + 1) + x];
+            pRow[(y + 1) * (nSide + 1) + x] = ('#' == pRow[(y + 1) * (nSide + 1) + x]) ? '.' : pRow[(y + 1) * (nSide + 1) + x];
+            pRow[y * (nSide + 1) + x - 1] = ('#' == pRow[y * (nSide + 1) + x - 1]) ? '.' : pRow[y * (nSide + 1) + x - 1];
+            pRow[y * (nSide + 1) + x + 1] = ('#' == pRow[y * (nSide + 1) + x + 1]) ? '.' : pRow[y * (nSide + 1) + x + 1];
+            k++;
+        }
+    }
+    return (pRow - pszText) + nSide * (nSide + 1);
+}
+
+///////////////////////////////////////////////////////////////////
+// 函	数：checkParallelBFS
+// 作	用：多线程BFS：在生成的CHECK_BFS_SIDE见方的无权空旷地图上，
+//			1）经库以ENGINE_BFS、CHECK_BFS_THREAD个线程生成完整距离矩阵，
+//			须确实多线程运行，且与Dijkstra参考矩阵逐项相同；
+//			2）直接以S为源点分别运行ParallelBFS与DialSearch，所有格子的
+//			距离须相同，且须有多线程处理的层
+// 参	数：void
+// 返	回：int		失败的检查数
+///////////////////////////////////////////////////////////////////
+static int checkParallelBFS()
+{
+    static char szText[16 + CHECK_BFS_SIDE * (CHECK_BFS_SIDE + 1)];
+    int nMatrix[MAX_POINT][MAX_POINT];
+    int nDiffer = 0;
+    int nFailed = 0;
+    size_t nLength = generateOpenMap(szText, CHECK_BFS_SIDE, CHECK_BFS_POINT);
+    Orienteering* pContext = new Orienteering();
+    Orienteering& o = *pContext;
+
+    o.setThreads(CHECK_BFS_THREAD);
+    bool bOk = (ORIENT_OK == prepare(o, szText, nLength, ENGINE_BFS, false)) && referenceMatrix(o, nMatrix);
+    for (int i = 0; bOk && (i < o.pointCount()); i++)
+    {
+        for (int j = 0; j < o.pointCount(); j++)
+        {
+            nDiffer += (nMatrix[i][j] != o.distance(i, j)) ? 1 : 0;
+        }
+    }
+    bOk = bOk && (0 == nDiffer) && (1 < o.bfs().activeThreads()) && (0 < o.bfs().parallelLevelCount());
+    printf("%-6s bfs     matrix  generated %dx%d  threads %d / %d  parallel levels %d  differ %d  %s\n",
+        bOk ? "ok" : "FAILED", CHECK_BFS_SIDE, CHECK_BFS_SIDE, o.bfs().activeThreads(), CHECK_BFS_THREAD,
+        o.bfs().parallelLevelCount(), nDiffer, bOk ? "" : "<--");
+    nFailed += bOk ? 0 : 1;
+
+    // 直接比较两个单源引擎
+    MyGrid grid;
+    DialSearch dial;
+    ParallelBFS bfs;
+    int nMismatch = 0;
+    bfs.setThreads(CHECK_BFS_THREAD);
+    bOk = (0 < o.width()) && buildGrid(o, grid, GRID_TILED);
+    int nSource = bOk ? grid.cell(o.point(0).x, o.point(0).y) : 0;
+    bOk = bOk && dial.run(grid, nSource) && bfs.run(grid, nSource);
+    for (int c = 0; bOk && (c < grid.size()); c++)
+    {
+        nMismatch += (dial.distance(c) != bfs.distance(c)) ? 1 : 0;
+    }
+    bOk = bOk && (0 == nMismatch) && (1 < bfs.activeThreads()) && (0 < bfs.parallelLevelCount());
+    printf("%-6s bfs     dial    generated %dx%d  levels %d (parallel %d, bottom-up %d)  mismatch %d  %s\n",
+        bOk ? "ok" : "FAILED", CHECK_BFS_SIDE, CHECK_BFS_SIDE, bfs.levelCount(), bfs.parallelLevelCount(),
+        bfs.bottomUpLevelCount(), nMismatch, bOk ? "" : "<--");
+    nFailed += bOk ? 0 : 1;
+    delete pContext;
+    return nFailed;
+}
+
+///////////////////////////////////////////////////////////////////
+// 函	数：main
+// 作	用：对每张地图先求基准结果，再逐个模式检查
+// 参	数：int argc		输入参数个数
+// 参	数：char* argv[]	地图文件名
+// 返	回：int		全部通过返回0，否则返回1
+///////////////////////////////////////////////////////////////////
+int main(int argc, char* argv[])
+{
+    const char* pszDefault[4] = { "example1.txt", "example2.txt", "example3.txt", "example4.txt" };
+    const char** ppszFiles = (1 < argc) ? (const char**)(argv + 1) : pszDefault;
+    int nFiles = (1 < argc) ? (argc - 1) : 4;
+    int nFailed = 0;
+    // 求解上下文含约2M的DP表，放在堆上
+    Orienteering* pRef = new Orienteering();
+
+    for (int f = 0; f < nFiles; f++)
+    {
+        size_t nLength = 0;
+        OrientPath path;
+        char* pszText = readMapFile(ppszFiles[f], &nLength);
+        if (NULL == pszText)
+        {
+            printf("FAILED can not open %s\n", ppszFiles[f]);
+            nFailed++;
+            continue;
+        }
+        if ((ORIENT_OK != prepare(*pRef, pszText, nLength, ENGINE_GRID, false)) || (ORIENT_OK != pRef->solvePath(&path)))
+        {
+            printf("FAILED %s has no exact result\n", ppszFiles[f]);
+            nFailed++;
+            free(pszText);
+            continue;
+        }
+        printf("exact  %-14s steps %d  points %d\n", ppszFiles[f], path.nSteps, pRef->pointCount());
+        nFailed += checkEngines(*pRef, ppszFiles[f], pszText, nLength);
+        nFailed += checkAllGoals(*pRef, ppszFiles[f], pszText, nLength);
+        nFailed += checkHeuristic(*pRef, ppszFiles[f], pszText, nLength);
+        nFailed += checkLazy(*pRef, path.nSteps, ppszFiles[f], pszText, nLength);
+        nFailed += checkCluster(*pRef, path.nSteps, ppszFiles[f], pszText, nLength);
+        nFailed += checkKBest(*pRef, path.nSteps, ppszFiles[f], pszText, nLength);
+        nFailed += checkPrize(*pRef, path.nSteps, ppszFiles[f], pszText, nLength);
+        free(pszText);
+    }
+    delete pRef;
+    nFailed += checkLargeMap();
+    nFailed += checkPrizeDP();
+    nFailed += checkMazeGraph();
+    nFailed += checkParallelBFS();
+    printf("%s: %d check(s) failed\n", (0 == nFailed) ? "PASSED" : "FAILED", nFailed);
+    return (0 == nFailed) ? 0 : 1;
+}
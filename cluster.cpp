@@ -0,0 +1,704 @@
+///////////////////////////////////////////////////////////////////
+// 文	件：cluster.cpp
+// 功	能：大点集的分簇求解（分簇、簇序、簇内并行DP、入口出口选择、交界修补）
+// 作	者：gengjian1203
+// 邮	箱：gengjian1203@foxmail.com
+///////////////////////////////////////////////////////////////////
+#include <stdlib.h>
+#include <limits.h>
+#include <thread>
+#include <system_error>
+#include "cluster.h"
+
+///////////////////////////////////////////////////////////////////
+// 函	数：compareClusterKey
+// 作	用：qsort比较函数，按距离递增、点索引递增排序
+///////////////////////////////////////////////////////////////////
+static int compareClusterKey(const void* pA, const void* pB)
+{
+    const MyClusterKey* a = (const MyClusterKey*)pA;
+    const MyClusterKey* b = (const MyClusterKey*)pB;
+    if (a->nDist != b->nDist)
+    {
+        return (a->nDist < b->nDist) ? -1 : 1;
+    }
+    return a->nPoint - b->nPoint;
+}
+
+///////////////////////////////////////////////////////////////////
+// 函	数：ClusterSolver
+// 作	用：构造函数
+// 参	数：void
+///////////////////////////////////////////////////////////////////
+ClusterSolver::ClusterSolver()
+{
+    m_pDist = NULL;
+    m_nPoints = 0;
+    m_nClusters = 0;
+    m_pCenter = NULL;
+    m_pClusterOf = NULL;
+    m_pStart = NULL;
+    m_pMember = NULL;
+    m_pOrder = NULL;
+    m_pEntry = NULL;
+    m_pExit = NULL;
+    m_pOffset = NULL;
+    m_pPairCost = NULL;
+    m_pBestIn = NULL;
+    m_pFromIn = NULL;
+    m_pBestOut = NULL;
+    m_pFromOut = NULL;
+    m_pKey = NULL;
+    m_pTable = NULL;
+    m_nNextCluster.store(0);
+    m_bPairPhase = false;
+    m_nRepairGain = 0;
+    m_nStitchCost = 0;
+    m_nCapacity = 0;
+    m_nThreadCapacity = 0;
+}
+
+///////////////////////////////////////////////////////////////////
+// 函	数：~ClusterSolver
+// 作	用：析构函数
+///////////////////////////////////////////////////////////////////
+ClusterSolver::~ClusterSolver()
+{
+    free(m_pCenter);
+    free(m_pClusterOf);
+    free(m_pStart);
+    free(m_pMember);
+    free(m_pOrder);
+    free(m_pEntry);
+    free(m_pExit);
+    free(m_pOffset);
+    free(m_pPairCost);
+    free(m_pBestIn);
+    free(m_pFromIn);
+    free(m_pBestOut);
+    free(m_pFromOut);
+    free(m_pKey);
+    free(m_pTable);
+}
+
+///////////////////////////////////////////////////////////////////
+// 函	数：reserve
+// 作	用：预先申请缓冲区（只增不减）。簇数不超过点数，各簇入口出口
+//			步数矩阵合计不超过nPoints * CLUSTER_MAX，每个线程一张
+//			(1<<CLUSTER_MAX) * CLUSTER_MAX的DP表
+// 参	数：int nPoints		点数
+// 参	数：int nThreads		线程数
+// 返	回：bool		内存申请失败返回假
+///////////////////////////////////////////////////////////////////
+bool ClusterSolver::reserve(int nPoints, int nThreads)
+{
+    if (nPoints > m_nCapacity)
+    {
+        free(m_pCenter);
+        free(m_pClusterOf);
+        free(m_pStart);
+        free(m_pMember);
+        free(m_pOrder);
+        free(m_pEntry);
+        free(m_pExit);
+        free(m_pOffset);
+        free(m_pPairCost);
+        free(m_pBestIn);
+        free(m_pFromIn);
+        free(m_pBestOut);
+        free(m_pFromOut);
+        free(m_pKey);
+        m_pCenter = (int*)malloc(nPoints * sizeof(int));
+        m_pClusterOf = (int*)malloc(nPoints * sizeof(int));
+        m_pStart = (int*)malloc((nPoints + 1) * sizeof(int));
+        m_pMember = (int*)malloc(nPoints * sizeof(int));
+        m_pOrder = (int*)malloc((nPoints + 2) * sizeof(int));
+        m_pEntry = (int*)malloc(nPoints * sizeof(int));
+        m_pExit = (int*)malloc(nPoints * sizeof(int));
+        m_pOffset = (int*)malloc(nPoints * sizeof(int));
+        m_pPairCost = (int*)malloc((size_t)nPoints * CLUSTER_MAX * sizeof(int));
+        m_pBestIn = (int*)malloc(nPoints * sizeof(int));
+        m_pFromIn = (int*)malloc(nPoints * sizeof(int));
+        m_pBestOut = (int*)malloc(nPoints * sizeof(int));
+        m_pFromOut = (int*)malloc(nPoints * sizeof(int));
+        m_pKey = (MyClusterKey*)malloc(nPoints * sizeof(MyClusterKey));
+        m_nCapacity = nPoints;
+        if ((NULL == m_pCenter) || (NULL == m_pClusterOf) || (NULL == m_pStart) || (NULL == m_pMember)
+            || (NULL == m_pOrder) || (NULL == m_pEntry) || (NULL == m_pExit) || (NULL == m_pOffset)
+            || (NULL == m_pPairCost) || (NULL == m_pBestIn) || (NULL == m_pFromIn) || (NULL == m_pBestOut)
+            || (NULL == m_pFromOut) || (NULL == m_pKey))
+        {
+            m_nCapacity = 0;
+            return false;
+        }
+    }
+    if (nThreads > m_nThreadCapacity)
+    {
+        free(m_pTable);
+        m_pTable = (int*)malloc((size_t)nThreads * (1<<CLUSTER_MAX) * CLUSTER_MAX * sizeof(int));
+        m_nThreadCapacity = nThreads;
+        if (NULL == m_pTable)
+        {
+            m_nThreadCapacity = 0;
+            return false;
+        }
+    }
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////
+// 函	数：solve
+// 作	用：分簇求S经过所有点到达G的路径
+// 参	数：const int* pnDist	nPoints * nPoints的对称距离矩阵（0为S，1为G）
+// 参	数：int nPoints		点数
+// 参	数：int nThreads		簇内求解的线程数
+// 参	数：int* pnRoute		输出nPoints个点的访问顺序
+// 返	回：int		路径步数，内存不足返回-1
+///////////////////////////////////////////////////////////////////
+int ClusterSolver::solve(const int* pnDist, int nPoints, int nThreads, int* pnRoute)
+{
+    int nCost = 0;
+
+    nThreads = (1 > nThreads) ? 1 : ((CLUSTER_MAX_THREAD < nThreads) ? CLUSTER_MAX_THREAD : nThreads);
+    if (!reserve(nPoints, nThreads))
+    {
+        return -1;
+    }
+    m_pDist = pnDist;
+    m_nPoints = nPoints;
+    m_nRepairGain = 0;
+    if (CLUSTER_MAX >= nPoints)
+    {
+        // 点数不多时整体一次DP即为精确解
+        for (int i = 0; i < nPoints; i++)
+        {
+            m_pMember[i] = i;
+        }
+        m_nClusters = 1;
+        fillDP(m_pMember, nPoints, 0, m_pTable);
+        backtrackDP(m_pMember, nPoints, 0, 1, m_pTable, pnRoute);
+        m_nStitchCost = m_pTable[((1<<nPoints) - 1) * nPoints + 1];
+        return m_nStitchCost;
+    }
+
+    buildClusters();
+    orderClusters();
+
+    // 各簇互不依赖：先并行求各簇任意入口到出口的步数，选定入口、出口后
+    // 再并行回溯簇内路径
+    runWorkers(true, pnRoute, nThreads);
+    m_nStitchCost = chooseBridges();
+    pnRoute[0] = 0;
+    pnRoute[nPoints - 1] = 1;
+    runWorkers(false, pnRoute, nThreads);
+
+    // 修补：在每个交界（含S之后、G之前）前后的窗口内改进
+    for (int i = 0; i <= m_nClusters; i++)
+    {
+        int nBoundary = (m_nClusters == i) ? (nPoints - 1) : m_pOffset[m_pOrder[i]];
+        int nBegin = (1 > nBoundary - CLUSTER_REPAIR) ? 1 : (nBoundary - CLUSTER_REPAIR);
+        int nEnd = (nPoints - 1 < nBoundary + CLUSTER_REPAIR) ? (nPoints - 1) : (nBoundary + CLUSTER_REPAIR);
+        m_nRepairGain += repairWindow(pnRoute, nBegin, nEnd);
+    }
+    // 交界修补只能改动局部，再对整条路径做一遍（拼接后的路径已接近局部最优，收敛很快）
+    m_nRepairGain += repairWindow(pnRoute, 1, nPoints - 1);
+    for (int i = 0; i + 1 < nPoints; i++)
+    {
+        nCost += dist(pnRoute[i], pnRoute[i + 1]);
+    }
+    return nCost;
+}
+
+///////////////////////////////////////////////////////////////////
+// 函	数：buildClusters
+// 作	用：分簇。最远点法选簇心（每次选离已有簇心和S最远的点），
+//			再交替进行分配和簇心更新
+// 参	数：void
+// 返	回：void
+///////////////////////////////////////////////////////////////////
+void ClusterSolver::buildClusters()
+{
+    int nChecks = m_nPoints - 2;
+    int* pMinDist = m_pEntry;
+
+    m_nClusters = (nChecks + CLUSTER_TARGET - 1) / CLUSTER_TARGET;
+    for (int p = 2; p < m_nPoints; p++)
+    {
+        pMinDist[p] = dist(0, p);
+        m_pClusterOf[p] = -1;
+    }
+    for (int c = 0; c < m_nClusters; c++)
+    {
+        int nFar = -1;
+        for (int p = 2; p < m_nPoints; p++)
+        {
+            if ((-1 == m_pClusterOf[p]) && ((-1 == nFar) || (pMinDist[p] > pMinDist[nFar])))
+            {
+                nFar = p;
+            }
+        }
+        m_pCenter[c] = nFar;
+        m_pClusterOf[nFar] = c;
+        for (int p = 2; p < m_nPoints; p++)
+        {
+            pMinDist[p] = (dist(nFar, p) < pMinDist[p]) ? dist(nFar, p) : pMinDist[p];
+        }
+    }
+
+    // 分配与簇心更新交替进行若干轮（带容量限制的k-medoids）
+    for (int nRound = 0; nRound < CLUSTER_ROUNDS; nRound++)
+    {
+        assignClusters();
+    }
+}
+
+///////////////////////////////////////////////////////////////////
+// 函	数：assignClusters
+// 作	用：一轮分配：各点按到最近簇心的距离由近到远，分给未满的最近
+//			簇心（簇心自身距离为0，最先分配）；然后把各簇的簇心换成到簇内
+//			其他点距离之和最小的点
+// 参	数：void
+// 返	回：void
+///////////////////////////////////////////////////////////////////
+void ClusterSolver::assignClusters()
+{
+    int nChecks = m_nPoints - 2;
+    int* pCount = m_pOffset;
+    MyClusterKey* pKey = m_pKey;
+
+    for (int p = 2; p < m_nPoints; p++)
+    {
+        int nMin = INT_MAX;
+        for (int c = 0; c < m_nClusters; c++)
+        {
+            nMin = (dist(m_pCenter[c], p) < nMin) ? dist(m_pCenter[c], p) : nMin;
+        }
+        pKey[p - 2].nDist = nMin;
+        pKey[p - 2].nPoint = p;
+    }
+    qsort(pKey, nChecks, sizeof(MyClusterKey), compareClusterKey);
+    for (int c = 0; c < m_nClusters; c++)
+    {
+        pCount[c] = 0;
+    }
+    for (int k = 0; k < nChecks; k++)
+    {
+        int p = pKey[k].nPoint;
+        int nBest = -1;
+        for (int c = 0; c < m_nClusters; c++)
+        {
+            if ((CLUSTER_MAX > pCount[c]) && ((-1 == nBest) || (dist(m_pCenter[c], p) < dist(m_pCenter[nBest], p))))
+            {
+                nBest = c;
+            }
+        }
+        m_pClusterOf[p] = nBest;
+        pCount[nBest]++;
+    }
+
+    // 各簇成员连续存放
+    m_pStart[0] = 0;
+    for (int c = 0; c < m_nClusters; c++)
+    {
+        m_pStart[c + 1] = m_pStart[c] + pCount[c];
+        pCount[c] = m_pStart[c];
+    }
+    for (int p = 2; p < m_nPoints; p++)
+    {
+        m_pMember[pCount[m_pClusterOf[p]]++] = p;
+    }
+
+    // 簇心换成簇内的中心点
+    for (int c = 0; c < m_nClusters; c++)
+    {
+        long long llBest = -1;
+        for (int a = m_pStart[c]; a < m_pStart[c + 1]; a++)
+        {
+            long long llSum = 0;
+            for (int b = m_pStart[c]; b < m_pStart[c + 1]; b++)
+            {
+                llSum += dist(m_pMember[a], m_pMember[b]);
+            }
+            if ((-1 == llBest) || (llSum < llBest))
+            {
+                llBest = llSum;
+                m_pCenter[c] = m_pMember[a];
+            }
+        }
+    }
+}
+
+///////////////////////////////////////////////////////////////////
+// 函	数：orderClusters
+// 作	用：求簇序：以簇心代表各簇，求S经过所有簇心到达G的路径。
+//			簇数较少时用DP，否则用最近邻构造后整体2-opt
+// 参	数：void
+// 返	回：void
+///////////////////////////////////////////////////////////////////
+void ClusterSolver::orderClusters()
+{
+    // 节点序列：S、各簇心、G
+    int* pNode = m_pOrder;
+    int nCount = m_nClusters + 2;
+
+    if (CLUSTER_MAX >= nCount)
+    {
+        int nTemp[CLUSTER_MAX];
+        nTemp[0] = 0;
+        nTemp[1] = 1;
+        for (int c = 0; c < m_nClusters; c++)
+        {
+            nTemp[c + 2] = m_pCenter[c];
+        }
+        fillDP(nTemp, nCount, 0, m_pTable);
+        backtrackDP(nTemp, nCount, 0, 1, m_pTable, pNode);
+    }
+    else
+    {
+        // 最近邻：从S出发每次走向最近的未访问簇心
+        pNode[0] = 0;
+        for (int c = 0; c < m_nClusters; c++)
+        {
+            pNode[c + 1] = m_pCenter[c];
+        }
+        for (int i = 1; i <= m_nClusters; i++)
+        {
+            int nBest = i;
+            for (int k = i + 1; k <= m_nClusters; k++)
+            {
+                if (dist(pNode[i - 1], pNode[k]) < dist(pNode[i - 1], pNode[nBest]))
+                {
+                    nBest = k;
+                }
+            }
+            int nSwap = pNode[i];
+            pNode[i] = pNode[nBest];
+            pNode[nBest] = nSwap;
+        }
+        pNode[m_nClusters + 1] = 1;
+        while (0 < repairWindow(pNode, 1, m_nClusters + 1))
+        {
+        }
+    }
+    // 簇心换回簇编号
+    for (int i = 0; i < m_nClusters; i++)
+    {
+        pNode[i] = m_pClusterOf[pNode[i + 1]];
+    }
+}
+
+///////////////////////////////////////////////////////////////////
+// 函	数：chooseBridges
+// 作	用：沿簇序DP选取各簇的入口、出口：m_pBestIn[a]为以成员a为入口
+//			时从S到达a的最少步数，m_pBestOut[a]为以a为出口时从S走完该簇
+//			到达a的最少步数。两者交替递推，最后取到G最近的出口回溯
+// 参	数：void
+// 返	回：int		拼接后的路径步数
+///////////////////////////////////////////////////////////////////
+int ClusterSolver::chooseBridges()
+{
+    int nPrev = -1;
+    int nOffset = 1;
+
+    for (int i = 0; i < m_nClusters; i++)
+    {
+        int c = m_pOrder[i];
+        int nBegin = m_pStart[c];
+        int nSize = m_pStart[c + 1] - nBegin;
+        const int* pPair = m_pPairCost + (size_t)nBegin * CLUSTER_MAX;
+        m_pOffset[c] = nOffset;
+        nOffset += nSize;
+        for (int a = nBegin; a < nBegin + nSize; a++)
+        {
+            m_pBestIn[a] = INT_MAX;
+            m_pFromIn[a] = -1;
+            if (-1 == nPrev)
+            {
+                m_pBestIn[a] = dist(0, m_pMember[a]);
+                continue;
+            }
+            for (int b = m_pStart[nPrev]; b < m_pStart[nPrev + 1]; b++)
+            {
+                if ((INT_MAX != m_pBestOut[b]) && (m_pBestOut[b] + dist(m_pMember[b], m_pMember[a]) < m_pBestIn[a]))
+                {
+                    m_pBestIn[a] = m_pBestOut[b] + dist(m_pMember[b], m_pMember[a]);
+                    m_pFromIn[a] = b;
+                }
+            }
+        }
+        for (int x = 0; x < nSize; x++)
+        {
+            m_pBestOut[nBegin + x] = INT_MAX;
+            m_pFromOut[nBegin + x] = -1;
+            for (int e = 0; e < nSize; e++)
+            {
+                int nPair = pPair[e * nSize + x];
+                if ((INT_MAX != nPair) && (INT_MAX != m_pBestIn[nBegin + e])
+                    && (m_pBestIn[nBegin + e] + nPair < m_pBestOut[nBegin + x]))
+                {
+                    m_pBestOut[nBegin + x] = m_pBestIn[nBegin + e] + nPair;
+                    m_pFromOut[nBegin + x] = nBegin + e;
+                }
+            }
+        }
+        nPrev = c;
+    }
+
+    // 最后一簇的出口到G，再逐簇回溯入口、出口
+    int nBest = INT_MAX;
+    int nExit = -1;
+    for (int b = m_pStart[nPrev]; b < m_pStart[nPrev + 1]; b++)
+    {
+        if ((INT_MAX != m_pBestOut[b]) && (m_pBestOut[b] + dist(m_pMember[b], 1) < nBest))
+        {
+            nBest = m_pBestOut[b] + dist(m_pMember[b], 1);
+            nExit = b;
+        }
+    }
+    for (int i = m_nClusters - 1; 0 <= i; i--)
+    {
+        int c = m_pOrder[i];
+        int nEntry = m_pFromOut[nExit];
+        m_pExit[c] = m_pMember[nExit];
+        m_pEntry[c] = m_pMember[nEntry];
+        nExit = m_pFromIn[nEntry];
+    }
+    return nBest;
+}
+
+///////////////////////////////////////////////////////////////////
+// 函	数：runWorkers
+// 作	用：多线程处理所有簇（各簇互不依赖，按访问顺序动态取簇）。
+//			线程每次调用时启动、结束时回收；无法创建线程时少用几个线程
+// 参	数：bool bPairPhase		真为计算入口出口步数矩阵，假为回溯簇内路径
+// 参	数：int* pnRoute		最终路径
+// 参	数：int nThreads		线程数
+// 返	回：void
+///////////////////////////////////////////////////////////////////
+void ClusterSolver::runWorkers(bool bPairPhase, int* pnRoute, int nThreads)
+{
+    std::thread worker[CLUSTER_MAX_THREAD];
+
+    m_bPairPhase = bPairPhase;
+    m_nNextCluster.store(0);
+    nThreads = (nThreads > m_nClusters) ? m_nClusters : nThreads;
+    for (int i = 1; i < nThreads; i++)
+    {
+        try
+        {
+            worker[i] = std::thread(&ClusterSolver::workerMain, this, i, pnRoute);
+        }
+        catch (const std::system_error&)
+        {
+            // 系统无法再创建线程：簇是动态领取的，已启动的线程照样能处理完所有簇
+            nThreads = i;
+            break;
+        }
+    }
+    workerMain(0, pnRoute);
+    for (int i = 1; i < nThreads; i++)
+    {
+        worker[i].join();
+    }
+}
+
+///////////////////////////////////////////////////////////////////
+// 函	数：workerMain
+// 作	用：工作线程：依次取出簇。计算步数矩阵时以每个成员为入口做一次
+//			DP，全集一行即为到各出口的步数；回溯时以选定的入口做DP，
+//			把到出口的路径写入最终路径中该簇的位置（各簇的输出位置
+//			不重叠，无需加锁）
+// 参	数：int nWorker		线程编号
+// 参	数：int* pnRoute		最终路径
+// 返	回：void
+///////////////////////////////////////////////////////////////////
+void ClusterSolver::workerMain(int nWorker, int* pnRoute)
+{
+    int* pTable = m_pTable + (size_t)nWorker * (1<<CLUSTER_MAX) * CLUSTER_MAX;
+    int i;
+    while (m_nClusters > (i = m_nNextCluster.fetch_add(1)))
+    {
+        int c = m_pOrder[i];
+        const int* pNode = m_pMember + m_pStart[c];
+        int nCount = m_pStart[c + 1] - m_pStart[c];
+        int nFull = (1<<nCount) - 1;
+        if (m_bPairPhase)
+        {
+            int* pPair = m_pPairCost + (size_t)m_pStart[c] * CLUSTER_MAX;
+            for (int e = 0; e < nCount; e++)
+            {
+                fillDP(pNode, nCount, e, pTable);
+                for (int x = 0; x < nCount; x++)
+                {
+                    pPair[e * nCount + x] = pTable[nFull * nCount + x];
+                }
+            }
+            continue;
+        }
+        int nFirst = 0;
+        int nLast = 0;
+        for (int k = 0; k < nCount; k++)
+        {
+            nFirst = (pNode[k] == m_pEntry[c]) ? k : nFirst;
+            nLast = (pNode[k] == m_pExit[c]) ? k : nLast;
+        }
+        fillDP(pNode, nCount, nFirst, pTable);
+        backtrackDP(pNode, nCount, nFirst, nLast, pTable, pnRoute + m_pOffset[c]);
+    }
+}
+
+///////////////////////////////////////////////////////////////////
+// 函	数：fillDP
+// 作	用：哈密顿DP：以pnNode[nFirst]为起点填写DP表。表中(m, j)为
+//			从起点出发恰好经过集合m、停在j的最少步数，全集一行即为
+//			经过全部点到各终点的最短步数（走不到为INT_MAX）
+// 参	数：const int* pnNode	点索引（nCount不超过CLUSTER_MAX）
+// 参	数：int nCount		点数
+// 参	数：int nFirst		起点在pnNode中的位置
+// 参	数：int* pnTable		DP表（(1<<nCount) * nCount）
+// 返	回：void
+///////////////////////////////////////////////////////////////////
+void ClusterSolver::fillDP(const int* pnNode, int nCount, int nFirst, int* pnTable)
+{
+    int nFull = (1<<nCount) - 1;
+
+    for (int i = 0; i <= nFull * nCount + nCount - 1; i++)
+    {
+        pnTable[i] = INT_MAX;
+    }
+    pnTable[(1<<nFirst) * nCount + nFirst] = 0;
+    for (int m = 0; m <= nFull; m++)
+    {
+        for (int j = 0; j < nCount; j++)
+        {
+            int nValue = pnTable[m * nCount + j];
+            if (INT_MAX == nValue)
+            {
+                continue;
+            }
+            for (int k = 0; k < nCount; k++)
+            {
+                if (m & (1<<k))
+                {
+                    continue;
+                }
+                int nNext = nValue + dist(pnNode[j], pnNode[k]);
+                int* pCell = &pnTable[(m | (1<<k)) * nCount + k];
+                *pCell = (nNext < *pCell) ? nNext : *pCell;
+            }
+        }
+    }
+}
+
+///////////////////////////////////////////////////////////////////
+// 函	数：backtrackDP
+// 作	用：从fillDP填好的表回溯终止于pnNode[nLast]的最短路径
+// 参	数：const int* pnNode	点索引
+// 参	数：int nCount		点数
+// 参	数：int nFirst		起点在pnNode中的位置
+// 参	数：int nLast		终点在pnNode中的位置（nCount为1时与起点相同）
+// 参	数：const int* pnTable	DP表
+// 参	数：int* pnOut		输出nCount个点的访问顺序
+// 返	回：void
+///////////////////////////////////////////////////////////////////
+void ClusterSolver::backtrackDP(const int* pnNode, int nCount, int nFirst, int nLast, const int* pnTable, int* pnOut)
+{
+    int nMask = (1<<nCount) - 1;
+    int nCur = nLast;
+
+    for (int nPos = nCount - 1; 0 < nPos; nPos--)
+    {
+        int nPrevMask = nMask & ~(1<<nCur);
+        pnOut[nPos] = pnNode[nCur];
+        for (int j = 0; j < nCount; j++)
+        {
+            if ((nPrevMask & (1<<j)) && (INT_MAX != pnTable[nPrevMask * nCount + j])
+                && (pnTable[nPrevMask * nCount + j] + dist(pnNode[j], pnNode[nCur]) == pnTable[nMask * nCount + nCur]))
+            {
+                nCur = j;
+                break;
+            }
+        }
+        nMask = nPrevMask;
+    }
+    pnOut[0] = pnNode[nFirst];
+}
+
+///////////////////////////////////////////////////////////////////
+// 函	数：repairWindow
+// 作	用：在路径的[nBegin, nEnd)区间内反复做2-opt（翻转一段）和单点移动，
+//			直到没有改进。区间两侧的节点保持不动（需1 <= nBegin，
+//			nEnd <= 路径长度 - 1）
+// 参	数：int* pnRoute		路径（点索引）
+// 参	数：int nBegin		区间起点
+// 参	数：int nEnd		区间终点（不含）
+// 返	回：int		减少的步数
+///////////////////////////////////////////////////////////////////
+int ClusterSolver::repairWindow(int* pnRoute, int nBegin, int nEnd)
+{
+    int* r = pnRoute;
+    int nGain = 0;
+    bool bImproved = true;
+
+    while (bImproved)
+    {
+        bImproved = false;
+        // 2-opt：翻转r[i..j]
+        for (int i = nBegin; i < nEnd; i++)
+        {
+            for (int j = i + 1; j < nEnd; j++)
+            {
+                int nDelta = dist(r[i - 1], r[j]) + dist(r[i], r[j + 1]) - dist(r[i - 1], r[i]) - dist(r[j], r[j + 1]);
+                if (0 > nDelta)
+                {
+                    for (int a = i, b = j; a < b; a++, b--)
+                    {
+                        int nSwap = r[a];
+                        r[a] = r[b];
+                        r[b] = nSwap;
+                    }
+                    nGain -= nDelta;
+                    bImproved = true;
+                }
+            }
+        }
+        // 单点移动：把r[i]移到r[p]与r[p + 1]之间
+        for (int i = nBegin; i < nEnd; i++)
+        {
+            int nRemove = dist(r[i - 1], r[i + 1]) - dist(r[i - 1], r[i]) - dist(r[i], r[i + 1]);
+            for (int p = nBegin - 1; p < nEnd; p++)
+            {
+                if ((p == i) || (p == i - 1))
+                {
+                    continue;
+                }
+                int nDelta = nRemove + dist(r[p], r[i]) + dist(r[i], r[p + 1]) - dist(r[p], r[p + 1]);
+                if (0 <= nDelta)
+                {
+                    continue;
+                }
+                int nMove = r[i];
+                if (p < i)
+                {
+                    for (int k = i; k > p + 1; k--)
+                    {
+                        r[k] = r[k - 1];
+                    }
+                    r[p + 1] = nMove;
+                }
+                else
+                {
+                    for (int k = i; k < p; k++)
+                    {
+                        r[k] = r[k + 1];
+                    }
+                    r[p] = nMove;
+                }
+                nGain -= nDelta;
+                bImproved = true;
+                break;
+            }
+        }
+    }
+    return nGain;
+}
@@ -0,0 +1,127 @@
+///////////////////////////////////////////////////////////////////
+// 文	件：cluster.h
+// 功	能：大点集的分簇求解。'@'多达数百个时整体的哈密顿DP无法运算，
+//			改为先分簇再求解：
+//			1）分簇：按最短路径距离（而非直线距离，墙隔开的房间自然分开）
+//			最远点选簇心，再按距离由近到远把各点分给未满的最近簇心，
+//			与簇心更新交替进行若干轮；
+//			2）簇序：以簇心之间的距离求S经过各簇到G的顺序；
+//			3）簇内：各簇以每个点为入口做一次哈密顿DP，得到任意入口、
+//			出口之间经过全簇的最短步数（各簇互不依赖，多线程并行）；
+//			再沿簇序做一次DP，选出整体最优的各簇入口和出口，最后并行
+//			回溯各簇的路径；
+//			4）拼接后先在簇的交界附近、再对整条路径做2-opt和单点移动，
+//			修补拼接处。
+//			输入为对称的距离矩阵，与棋盘无关。
+// 作	者：gengjian1203
+// 邮	箱：gengjian1203@foxmail.com
+///////////////////////////////////////////////////////////////////
+#ifndef ORIENTEERING_CLUSTER_H
+#define ORIENTEERING_CLUSTER_H
+
+#include <atomic>
+
+// 簇的目标大小与上限（簇内哈密顿DP表为(1<<CLUSTER_MAX) * CLUSTER_MAX）
+#define CLUSTER_TARGET 8
+#define CLUSTER_MAX 10
+// 分簇时分配与簇心更新的轮数
+#define CLUSTER_ROUNDS 5
+// 修补：每个交界前后各CLUSTER_REPAIR个节点的窗口
+#define CLUSTER_REPAIR 6
+// 最大线程数
+#define CLUSTER_MAX_THREAD 64
+
+// 分簇时按到最近簇心的距离排序的点
+struct MyClusterKey
+{
+    // 到最近簇心的距离
+    int nDist;
+    // 点索引
+    int nPoint;
+
+};
+
+class ClusterSolver
+{
+public:
+    ClusterSolver();
+    ~ClusterSolver();
+    // 预先申请nPoints个点、nThreads个线程的缓冲区（只增不减）
+    bool reserve(int nPoints, int nThreads);
+    // 求S（0）经过所有点到达G（1）的路径。pnDist为nPoints * nPoints的
+    // 对称距离矩阵（任意两点可达），pnRoute输出nPoints个点的访问顺序
+    int solve(const int* pnDist, int nPoints, int nThreads, int* pnRoute);
+    // 上次求解的统计信息：簇数、修补减少的步数
+    int clusterCount() const { return m_nClusters; }
+    int repairGain() const { return m_nRepairGain; }
+    // 拼接后（修补前）的路径步数
+    int stitchCost() const { return m_nStitchCost; }
+
+private:
+    // 距离矩阵及点数
+    const int* m_pDist;
+    int m_nPoints;
+    // 簇数
+    int m_nClusters;
+    // 各簇心（点索引），以及各点所属的簇
+    int* m_pCenter;
+    int* m_pClusterOf;
+    // 各簇成员：簇c的成员为m_pMember[m_pStart[c]] ~ m_pMember[m_pStart[c + 1] - 1]
+    int* m_pStart;
+    int* m_pMember;
+    // 簇的访问顺序，各簇的入口、出口（点索引）
+    int* m_pOrder;
+    int* m_pEntry;
+    int* m_pExit;
+    // 各簇的路径在最终路径中的起始位置
+    int* m_pOffset;
+    // 各簇任意入口到出口经过全簇的最短步数：簇c为从m_pPairCost[m_pStart[c] * CLUSTER_MAX]
+    // 开始的nSize * nSize矩阵（nSize为簇c的成员数，下标为成员序号）
+    int* m_pPairCost;
+    // 入口、出口选择DP（按成员位置索引）：到达该成员作为入口/出口的最少步数及前驱
+    int* m_pBestIn;
+    int* m_pFromIn;
+    int* m_pBestOut;
+    int* m_pFromOut;
+    // 分簇时的排序缓冲区
+    MyClusterKey* m_pKey;
+    // 各线程的哈密顿DP表
+    int* m_pTable;
+    // 下一个待求解的簇（按访问顺序的下标，多线程共享）
+    std::atomic<int> m_nNextCluster;
+    // 工作线程的任务：真为计算入口出口步数矩阵，假为回溯簇内路径
+    bool m_bPairPhase;
+    // 修补减少的步数、拼接后的步数
+    int m_nRepairGain;
+    int m_nStitchCost;
+    // 已申请的点数与线程数
+    int m_nCapacity;
+    int m_nThreadCapacity;
+
+private:
+    // 两点距离
+    int dist(int i, int j) const { return m_pDist[i * m_nPoints + j]; }
+    // 分簇
+    void buildClusters();
+    // 一轮分配与簇心更新
+    void assignClusters();
+    // 求簇序
+    void orderClusters();
+    // 沿簇序DP选取各簇的入口、出口
+    int chooseBridges();
+    // 多线程处理所有簇
+    void runWorkers(bool bPairPhase, int* pnRoute, int nThreads);
+    // 工作线程：依次取出簇处理
+    void workerMain(int nWorker, int* pnRoute);
+    // 以pnNode[nFirst]为起点填写哈密顿DP表
+    void fillDP(const int* pnNode, int nCount, int nFirst, int* pnTable);
+    // 从DP表回溯终止于pnNode[nLast]的路径
+    void backtrackDP(const int* pnNode, int nCount, int nFirst, int nLast, const int* pnTable, int* pnOut);
+    // 在路径的[nBegin, nEnd)区间内做2-opt和单点移动，返回减少的步数
+    int repairWindow(int* pnRoute, int nBegin, int nEnd);
+
+    ClusterSolver(const ClusterSolver&);
+    ClusterSolver& operator=(const ClusterSolver&);
+};
+
+#endif
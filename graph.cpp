@@ -0,0 +1,348 @@
+///////////////////////////////////////////////////////////////////
+// 文	件：graph.cpp
+// 功	能：棋盘收缩为稀疏图（剪枝死胡同、收缩通道）及其上的最短路径
+// 作	者：gengjian1203
+// 邮	箱：gengjian1203@foxmail.com
+///////////////////////////////////////////////////////////////////
+#include <stdlib.h>
+#include <limits.h>
+#include "graph.h"
+
+///////////////////////////////////////////////////////////////////
+// 函	数：MyCorridorGraph
+// 作	用：构造函数
+// 参	数：void
+///////////////////////////////////////////////////////////////////
+MyCorridorGraph::MyCorridorGraph()
+{
+    m_nNodes = 0;
+    m_nEdges = 0;
+    m_nCells = 0;
+    m_nPruned = 0;
+    m_pNodeOfCell = NULL;
+    m_pDegree = NULL;
+    m_pQueue = NULL;
+    m_pRowStart = NULL;
+    m_pAdj = NULL;
+    m_pWeight = NULL;
+    m_pDist = NULL;
+    m_pHeapKey = NULL;
+    m_pHeapNode = NULL;
+    m_pHeapNext = NULL;
+    m_nHeapUsed = 0;
+    m_nHeapSize = 0;
+    m_nHeapLast = 0;
+    m_nCapacity = 0;
+}
+
+///////////////////////////////////////////////////////////////////
+// 函	数：~MyCorridorGraph
+// 作	用：析构函数
+///////////////////////////////////////////////////////////////////
+MyCorridorGraph::~MyCorridorGraph()
+{
+    free(m_pNodeOfCell);
+    free(m_pDegree);
+    free(m_pQueue);
+    free(m_pRowStart);
+    free(m_pAdj);
+    free(m_pWeight);
+    free(m_pDist);
+    free(m_pHeapKey);
+    free(m_pHeapNode);
+    free(m_pHeapNext);
+}
+
+///////////////////////////////////////////////////////////////////
+// 函	数：reserve
+// 作	用：预先申请nCells个格子规模的缓冲区（只增不减）。图节点数不超过
+//			格子数，每个节点最多4条出边；Dijkstra每次松弛放入一个堆元素，
+//			堆元素数不超过边数加1
+// 参	数：int nCells		格子数
+// 返	回：bool		内存申请失败返回假
+///////////////////////////////////////////////////////////////////
+bool MyCorridorGraph::reserve(int nCells)
+{
+    if (nCells <= m_nCapacity)
+    {
+        return true;
+    }
+    free(m_pNodeOfCell);
+    free(m_pDegree);
+    free(m_pQueue);
+    free(m_pRowStart);
+    free(m_pAdj);
+    free(m_pWeight);
+    free(m_pDist);
+    free(m_pHeapKey);
+    free(m_pHeapNode);
+    free(m_pHeapNext);
+    m_pNodeOfCell = (int*)malloc(nCells * sizeof(int));
+    m_pDegree = (int*)malloc(nCells * sizeof(int));
+    m_pQueue = (int*)malloc(nCells * sizeof(int));
+    m_pRowStart = (int*)malloc((nCells + 1) * sizeof(int));
+    m_pAdj = (int*)malloc(4 * nCells * sizeof(int));
+    m_pWeight = (int*)malloc(4 * nCells * sizeof(int));
+    m_pDist = (int*)malloc(nCells * sizeof(int));
+    m_pHeapKey = (int*)malloc((4 * nCells + 1) * sizeof(int));
+    m_pHeapNode = (int*)malloc((4 * nCells + 1) * sizeof(int));
+    m_pHeapNext = (int*)malloc((4 * nCells + 1) * sizeof(int));
+    if ((NULL == m_pNodeOfCell) || (NULL == m_pDegree) || (NULL == m_pQueue) || (NULL == m_pRowStart)
+        || (NULL == m_pAdj) || (NULL == m_pWeight) || (NULL == m_pDist)
+        || (NULL == m_pHeapKey) || (NULL == m_pHeapNode) || (NULL == m_pHeapNext))
+    {
+        m_nCapacity = 0;
+        return false;
+    }
+    m_nCapacity = nCells;
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////
+// 函	数：build
+// 作	用：由棋盘生成收缩图
+// 参	数：const MyGrid& grid		棋盘
+// 参	数：const int* pnPointCell	必须保留为节点的格子（'S'/'G'/'@'）
+// 参	数：int nPointCount			保留格子个数
+// 返	回：bool		内存申请失败返回假
+///////////////////////////////////////////////////////////////////
+bool MyCorridorGraph::build(const MyGrid& grid, const int* pnPointCell, int nPointCount)
+{
+    int nSize = grid.size();
+    int nHead = 0;
+    int nTail = 0;
+
+    if (!reserve(nSize))
+    {
+        return false;
+    }
+    // 统计各可行格子的可行邻居数
+    m_nCells = 0;
+    for (int c = 0; c < nSize; c++)
+    {
+        m_pNodeOfCell[c] = -1;
+        m_pDegree[c] = -1;
+        if (!grid.isSure(c))
+        {
+            continue;
+        }
+        m_nCells++;
+        m_pDegree[c] = 0;
+        for (int d = 0; d < 4; d++)
+        {
+            if (grid.isSure(grid.neighbour(c, d)))
+            {
+                m_pDegree[c]++;
+            }
+        }
+    }
+    for (int k = 0; k < nPointCount; k++)
+    {
+        m_pNodeOfCell[pnPointCell[k]] = -2;
+    }
+
+    // 剪枝：删除可行邻居不超过1个的非保留格子，其邻居可能随之成为新的死胡同末端
+    for (int c = 0; c < nSize; c++)
+    {
+        if ((0 <= m_pDegree[c]) && (1 >= m_pDegree[c]) && (-2 != m_pNodeOfCell[c]))
+        {
+            m_pQueue[nTail++] = c;
+        }
+    }
+    m_nPruned = 0;
+    while (nHead < nTail)
+    {
+        int nCell = m_pQueue[nHead++];
+        m_pDegree[nCell] = -1;
+        m_nPruned++;
+        for (int d = 0; d < 4; d++)
+        {
+            int nNext = grid.neighbour(nCell, d);
+            if (0 > m_pDegree[nNext])
+            {
+                continue;
+            }
+            // 邻居度数降到1时入队（度数0的孤立格子已在初始时入队）
+            if ((1 == --m_pDegree[nNext]) && (-2 != m_pNodeOfCell[nNext]))
+            {
+                m_pQueue[nTail++] = nNext;
+            }
+        }
+    }
+
+    // 编号节点：保留格子以及度数不为2的格子（路口）
+    m_nNodes = 0;
+    for (int c = 0; c < nSize; c++)
+    {
+        if ((0 <= m_pDegree[c]) && ((-2 == m_pNodeOfCell[c]) || (2 != m_pDegree[c])))
+        {
+            m_pQueue[m_nNodes] = c;
+            m_pNodeOfCell[c] = m_nNodes++;
+        }
+    }
+
+    // 收缩：节点按编号顺序逐个沿四个方向走通道链，出边连续存放即为CSR
+    // （只由度数2的格子组成、不含节点的环路与任何点都不连通，不会被走到）
+    m_nEdges = 0;
+    for (int u = 0; u < m_nNodes; u++)
+    {
+        m_pRowStart[u] = m_nEdges;
+        for (int d = 0; d < 4; d++)
+        {
+            int nWeight;
+            int nTo = walkChain(grid, m_pQueue[u], d, &nWeight);
+            if ((-1 == nTo) || (u == nTo))
+            {
+                continue;
+            }
+            m_pAdj[m_nEdges] = nTo;
+            m_pWeight[m_nEdges] = nWeight;
+            m_nEdges++;
+        }
+    }
+    m_pRowStart[m_nNodes] = m_nEdges;
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////
+// 函	数：walkChain
+// 作	用：从节点所在格子沿nDir方向走通道链，直到到达下一个节点
+//			（链上格子度数都为2，每步只有一个不回头的方向）
+// 参	数：const MyGrid& grid	棋盘
+// 参	数：int nFrom		起始节点所在格子
+// 参	数：int nDir		出发方向
+// 参	数：int* pnWeight	输出沿链进入各格子（含终点节点）的代价之和
+// 返	回：int		到达的图节点，该方向不可行返回-1
+///////////////////////////////////////////////////////////////////
+int MyCorridorGraph::walkChain(const MyGrid& grid, int nFrom, int nDir, int* pnWeight)
+{
+    int nPrev = nFrom;
+    int nCur = grid.neighbour(nFrom, nDir);
+    if (0 > m_pDegree[nCur])
+    {
+        return -1;
+    }
+    *pnWeight = grid.cost(nCur);
+    while (0 > m_pNodeOfCell[nCur])
+    {
+        int nNext = -1;
+        for (int d = 0; d < 4; d++)
+        {
+            int nCell = grid.neighbour(nCur, d);
+            if ((nCell != nPrev) && (0 <= m_pDegree[nCell]))
+            {
+                nNext = nCell;
+                break;
+            }
+        }
+        nPrev = nCur;
+        nCur = nNext;
+        *pnWeight += grid.cost(nCur);
+    }
+    return m_pNodeOfCell[nCur];
+}
+
+///////////////////////////////////////////////////////////////////
+// 函	数：pushHeap
+// 作	用：基数堆放入元素。键值按与上次取出值异或后的最高位分桶，
+//			键值不小于上次取出值（Dijkstra的单调性）
+// 参	数：int nKey		键值（代价）
+// 参	数：int nNode		图节点
+// 返	回：void
+///////////////////////////////////////////////////////////////////
+void MyCorridorGraph::pushHeap(int nKey, int nNode)
+{
+    unsigned int nDiff = (unsigned int)(nKey ^ m_nHeapLast);
+    int nBucket = (0 == nDiff) ? 0 : (32 - __builtin_clz(nDiff));
+    int e = m_nHeapUsed++;
+    m_pHeapKey[e] = nKey;
+    m_pHeapNode[e] = nNode;
+    m_pHeapNext[e] = m_nHeapHead[nBucket];
+    m_nHeapHead[nBucket] = e;
+    m_nHeapSize++;
+}
+
+///////////////////////////////////////////////////////////////////
+// 函	数：popHeap
+// 作	用：基数堆取出键值最小的元素。桶0为空时，取第一个非空桶中的
+//			最小键值作为新的基准，把该桶元素重新分到更低的桶中
+// 参	数：int* pnKey		输出键值
+// 返	回：int		图节点
+///////////////////////////////////////////////////////////////////
+int MyCorridorGraph::popHeap(int* pnKey)
+{
+    if (-1 == m_nHeapHead[0])
+    {
+        int b = 1;
+        while (-1 == m_nHeapHead[b])
+        {
+            b++;
+        }
+        int nMin = INT_MAX;
+        for (int e = m_nHeapHead[b]; -1 != e; e = m_pHeapNext[e])
+        {
+            nMin = (m_pHeapKey[e] < nMin) ? m_pHeapKey[e] : nMin;
+        }
+        m_nHeapLast = nMin;
+        int e = m_nHeapHead[b];
+        m_nHeapHead[b] = -1;
+        while (-1 != e)
+        {
+            int nNext = m_pHeapNext[e];
+            unsigned int nDiff = (unsigned int)(m_pHeapKey[e] ^ m_nHeapLast);
+            int nBucket = (0 == nDiff) ? 0 : (32 - __builtin_clz(nDiff));
+            m_pHeapNext[e] = m_nHeapHead[nBucket];
+            m_nHeapHead[nBucket] = e;
+            e = nNext;
+        }
+    }
+    int e = m_nHeapHead[0];
+    m_nHeapHead[0] = m_pHeapNext[e];
+    m_nHeapSize--;
+    *pnKey = m_pHeapKey[e];
+    return m_pHeapNode[e];
+}
+
+///////////////////////////////////////////////////////////////////
+// 函	数：run
+// 作	用：从图节点nSource出发运行Dijkstra（基数堆，过期元素取出时跳过），
+//			结果通过distance查询
+// 参	数：int nSource		源点图节点
+// 返	回：void
+///////////////////////////////////////////////////////////////////
+void MyCorridorGraph::run(int nSource)
+{
+    for (int i = 0; i < m_nNodes; i++)
+    {
+        m_pDist[i] = INT_MAX;
+    }
+    for (int b = 0; b < RADIX_BUCKET; b++)
+    {
+        m_nHeapHead[b] = -1;
+    }
+    m_nHeapUsed = 0;
+    m_nHeapSize = 0;
+    m_nHeapLast = 0;
+    m_pDist[nSource] = 0;
+    pushHeap(0, nSource);
+
+    while (0 < m_nHeapSize)
+    {
+        int nKey;
+        int u = popHeap(&nKey);
+        if (nKey > m_pDist[u])
+        {
+            continue;
+        }
+        for (int e = m_pRowStart[u]; e < m_pRowStart[u + 1]; e++)
+        {
+            int v = m_pAdj[e];
+            int nCost = nKey + m_pWeight[e];
+            if (nCost < m_pDist[v])
+            {
+                m_pDist[v] = nCost;
+                pushHeap(nCost, v);
+            }
+        }
+    }
+}
@@ -0,0 +1,84 @@
+///////////////////////////////////////////////////////////////////
+// 文	件：graph.h
+// 功	能：棋盘收缩为稀疏图。地图多为一格宽的通道和死胡同，逐格搜索
+//			浪费在这些格子上。预处理分两步：
+//			1）剪枝：反复删除可行邻居不超过1个、且不是'S'/'G'/'@'的格子，
+//			不含节点的死胡同整支被删掉（最短路径不会进入死胡同再退出）；
+//			2）收缩：节点（'S'/'G'/'@'及可行邻居数不为2的格子）之间的
+//			通道链收缩为一条带权边，权值为沿链进入各格子的代价之和。
+//			结果以CSR数组存放，在其上用基数堆（radix heap）做Dijkstra，
+//			得到的点对距离与在棋盘上逐格搜索完全相同。
+// 作	者：gengjian1203
+// 邮	箱：gengjian1203@foxmail.com
+///////////////////////////////////////////////////////////////////
+#ifndef ORIENTEERING_GRAPH_H
+#define ORIENTEERING_GRAPH_H
+
+#include "grid.h"
+
+// 基数堆的桶数（键值与上次取出值的差按最高位分桶）
+#define RADIX_BUCKET 33
+
+class MyCorridorGraph
+{
+public:
+    MyCorridorGraph();
+    ~MyCorridorGraph();
+    // 预先申请nCells个格子规模的缓冲区（之后不超过该规模的地图不再申请内存）
+    bool reserve(int nCells);
+    // 由棋盘生成收缩图，pnPointCell为必须保留的格子（'S'/'G'/'@'）
+    bool build(const MyGrid& grid, const int* pnPointCell, int nPointCount);
+    // 从图节点nSource出发运行Dijkstra，结果通过distance查询
+    void run(int nSource);
+    // 格子对应的图节点，不是节点返回-1
+    int nodeOfCell(int nCell) const { return m_pNodeOfCell[nCell]; }
+    // 源点到图节点的最短代价，不可达为INT_MAX
+    int distance(int nNode) const { return m_pDist[nNode]; }
+    // 统计信息
+    int nodeCount() const { return m_nNodes; }
+    int edgeCount() const { return m_nEdges; }
+    int cellCount() const { return m_nCells; }
+    int prunedCount() const { return m_nPruned; }
+
+private:
+    // 规模统计：图节点数、边数、可行格子数、剪掉的格子数
+    int m_nNodes;
+    int m_nEdges;
+    int m_nCells;
+    int m_nPruned;
+    // 各格子：对应的图节点（-1不是节点，-2为待保留的点）
+    int* m_pNodeOfCell;
+    // 各格子：剩余可行邻居数（-1为障碍物或已剪掉）
+    int* m_pDegree;
+    // 剪枝队列
+    int* m_pQueue;
+    // CSR：图节点i的出边为m_pAdj[m_pRowStart[i]] ~ m_pAdj[m_pRowStart[i + 1] - 1]
+    int* m_pRowStart;
+    int* m_pAdj;
+    int* m_pWeight;
+    // 各图节点到源点的最短代价
+    int* m_pDist;
+    // 基数堆：元素池（键值、图节点、桶内链表）
+    int* m_pHeapKey;
+    int* m_pHeapNode;
+    int* m_pHeapNext;
+    int m_nHeapUsed;
+    int m_nHeapSize;
+    int m_nHeapLast;
+    int m_nHeapHead[RADIX_BUCKET];
+    // 已申请的格子数（只增不减，重复使用）
+    int m_nCapacity;
+
+private:
+    // 沿通道链从节点走到下一个节点
+    int walkChain(const MyGrid& grid, int nFrom, int nDir, int* pnWeight);
+    // 基数堆：放入元素
+    void pushHeap(int nKey, int nNode);
+    // 基数堆：取出键值最小的元素
+    int popHeap(int* pnKey);
+
+    MyCorridorGraph(const MyCorridorGraph&);
+    MyCorridorGraph& operator=(const MyCorridorGraph&);
+};
+
+#endif
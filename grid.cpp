@@ -0,0 +1,97 @@
+///////////////////////////////////////////////////////////////////
+// 文	件：grid.cpp
+// 功	能：棋盘存储层的创建与设置
+// 作	者：gengjian1203
+// 邮	箱：gengjian1203@foxmail.com
+///////////////////////////////////////////////////////////////////
+#include <stdlib.h>
+#include <string.h>
+#include "grid.h"
+
+///////////////////////////////////////////////////////////////////
+// 函	数：MyGrid
+// 作	用：构造函数
+// 参	数：void
+///////////////////////////////////////////////////////////////////
+MyGrid::MyGrid()
+{
+    m_nWidth = 0;
+    m_nHeight = 0;
+    m_nLayout = GRID_ROW_MAJOR;
+    m_nStride = 0;
+    m_nSize = 0;
+    m_nCapacity = 0;
+    m_pCost = NULL;
+}
+
+///////////////////////////////////////////////////////////////////
+// 函	数：~MyGrid
+// 作	用：析构函数
+///////////////////////////////////////////////////////////////////
+MyGrid::~MyGrid()
+{
+    free(m_pCost);
+}
+
+///////////////////////////////////////////////////////////////////
+// 函	数：create
+// 作	用：创建宽nWidth、高nHeight的棋盘，全部初始化为障碍物
+//			（四周的哨兵和分块补齐部分始终保持为障碍物）
+// 参	数：int nWidth		地图宽
+// 参	数：int nHeight		地图高
+// 参	数：int nLayout		存储顺序（GRID_ROW_MAJOR或GRID_TILED）
+// 返	回：bool		内存申请失败返回假
+///////////////////////////////////////////////////////////////////
+bool MyGrid::create(int nWidth, int nHeight, int nLayout)
+{
+    int nPadWidth = nWidth + 2;
+    int nPadHeight = nHeight + 2;
+    int nSize;
+
+    if (GRID_TILED == nLayout)
+    {
+        // 补齐到整块
+        m_nStride = (nPadWidth + GRID_TILE - 1) >> GRID_TILE_SHIFT;
+        nSize = m_nStride * ((nPadHeight + GRID_TILE - 1) >> GRID_TILE_SHIFT) * GRID_TILE * GRID_TILE;
+    }
+    else
+    {
+        nLayout = GRID_ROW_MAJOR;
+        m_nStride = nPadWidth;
+        nSize = nPadWidth * nPadHeight;
+    }
+    if (nSize > m_nCapacity)
+    {
+        unsigned char* pCost = (unsigned char*)realloc(m_pCost, nSize);
+        if (NULL == pCost)
+        {
+            return false;
+        }
+        m_pCost = pCost;
+        m_nCapacity = nSize;
+    }
+    memset(m_pCost, 0, nSize);
+
+    m_nWidth = nWidth;
+    m_nHeight = nHeight;
+    m_nLayout = nLayout;
+    m_nSize = nSize;
+    m_nOffset[DIR_UP] = -m_nStride;
+    m_nOffset[DIR_DOWN] = m_nStride;
+    m_nOffset[DIR_LEFT] = -1;
+    m_nOffset[DIR_RIGHT] = 1;
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////
+// 函	数：setCost
+// 作	用：设置格子(x, y)的通行代价
+// 参	数：int x			横坐标（0 <= x < width）
+// 参	数：int y			纵坐标（0 <= y < height）
+// 参	数：int nCost		通行代价（0为障碍物，1~MAX_COST）
+// 返	回：void
+///////////////////////////////////////////////////////////////////
+void MyGrid::setCost(int x, int y, int nCost)
+{
+    m_pCost[cell(x, y)] = (unsigned char)nCost;
+}
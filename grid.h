@@ -0,0 +1,119 @@
+///////////////////////////////////////////////////////////////////
+// 文	件：grid.h
+// 功	能：棋盘存储层。所有搜索引擎都通过MyGrid访问格子：
+//			1）地图四周加一圈墙作为哨兵，扩展邻居时无需判断越界；
+//			2）可选行优先或分块（8x8一块）两种存储顺序。分块存储时
+//			上下相邻的格子大多在同一块内，大地图上搜索的局部访问
+//			能留在缓存和TLB中。
+//			格子用下标（int）表示，邻居通过neighbour取得，搜索引擎
+//			不需要关心具体的存储顺序。
+// 作	者：gengjian1203
+// 邮	箱：gengjian1203@foxmail.com
+///////////////////////////////////////////////////////////////////
+#ifndef ORIENTEERING_GRID_H
+#define ORIENTEERING_GRID_H
+
+// 地形通行代价：'.'、'S'、'G'、'@'代价为1，数字字符'1'~'9'为对应代价的慢行区域
+// （楼梯、坡道、拥堵通道等）。代价0表示障碍物。桶队列的桶数为MAX_COST + 1
+#define MAX_COST 9
+
+// 存储顺序
+#define GRID_ROW_MAJOR 0
+#define GRID_TILED 1
+// 分块边长（2的幂）
+#define GRID_TILE_SHIFT 3
+#define GRID_TILE (1<<GRID_TILE_SHIFT)
+
+// 邻居方向：上、下、左、右
+#define DIR_UP 0
+#define DIR_DOWN 1
+#define DIR_LEFT 2
+#define DIR_RIGHT 3
+
+class MyGrid
+{
+public:
+    MyGrid();
+    ~MyGrid();
+    // 创建宽nWidth、高nHeight的棋盘，全部初始化为障碍物
+    bool create(int nWidth, int nHeight, int nLayout);
+    // 设置格子(x, y)的通行代价（0为障碍物）
+    void setCost(int x, int y, int nCost);
+
+    // 地图宽高（不含哨兵）
+    int width() const { return m_nWidth; }
+    int height() const { return m_nHeight; }
+    // 存储顺序
+    int layout() const { return m_nLayout; }
+    // 存储的格子总数（含哨兵及分块补齐部分），格子下标范围为[0, size())
+    int size() const { return m_nSize; }
+
+    // 坐标(x, y)对应的格子下标，-1 <= x <= width，-1 <= y <= height
+    int cell(int x, int y) const
+    {
+        int px = x + 1;
+        int py = y + 1;
+        if (GRID_ROW_MAJOR == m_nLayout)
+        {
+            return py * m_nStride + px;
+        }
+        return (((py >> GRID_TILE_SHIFT) * m_nStride + (px >> GRID_TILE_SHIFT)) << (2 * GRID_TILE_SHIFT))
+            + ((py & (GRID_TILE - 1)) << GRID_TILE_SHIFT) + (px & (GRID_TILE - 1));
+    }
+    // 格子的通行代价（0为障碍物）
+    int cost(int nCell) const
+    {
+        return m_pCost[nCell];
+    }
+    // 格子是否为可行区域
+    bool isSure(int nCell) const
+    {
+        return (0 != m_pCost[nCell]);
+    }
+    // 格子在nDir方向上的邻居下标（哨兵保证可行格子的邻居不会越界）
+    int neighbour(int nCell, int nDir) const
+    {
+        if (GRID_ROW_MAJOR == m_nLayout)
+        {
+            return nCell + m_nOffset[nDir];
+        }
+        // 分块存储：块内直接偏移，跨块时跳到相邻块的对边
+        const int nMask = GRID_TILE - 1;
+        const int nTileCells = GRID_TILE * GRID_TILE;
+        switch (nDir)
+        {
+        case DIR_UP:
+            return (0 != ((nCell >> GRID_TILE_SHIFT) & nMask)) ? (nCell - GRID_TILE)
+                : (nCell - m_nStride * nTileCells + nMask * GRID_TILE);
+        case DIR_DOWN:
+            return (nMask != ((nCell >> GRID_TILE_SHIFT) & nMask)) ? (nCell + GRID_TILE)
+                : (nCell + m_nStride * nTileCells - nMask * GRID_TILE);
+        case DIR_LEFT:
+            return (0 != (nCell & nMask)) ? (nCell - 1) : (nCell - nTileCells + nMask);
+        default:
+            return (nMask != (nCell & nMask)) ? (nCell + 1) : (nCell + nTileCells - nMask);
+        }
+    }
+
+private:
+    // 地图宽高（不含哨兵）
+    int m_nWidth;
+    int m_nHeight;
+    // 存储顺序
+    int m_nLayout;
+    // 行优先：每行格子数；分块：每行块数
+    int m_nStride;
+    // 存储的格子总数
+    int m_nSize;
+    // m_pCost已申请的格子数（只增不减，重复使用）
+    int m_nCapacity;
+    // 行优先时四个方向的下标偏移
+    int m_nOffset[4];
+    // 各格子的通行代价
+    unsigned char* m_pCost;
+
+    MyGrid(const MyGrid&);
+    MyGrid& operator=(const MyGrid&);
+};
+
+#endif
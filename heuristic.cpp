@@ -0,0 +1,180 @@
+///////////////////////////////////////////////////////////////////
+// 文	件：heuristic.cpp
+// 功	能：A*算法的hAstar估价子系统（曼哈顿距离、ALT地标）
+// 作	者：gengjian1203
+// 邮	箱：gengjian1203@foxmail.com
+///////////////////////////////////////////////////////////////////
+#include <stdlib.h>
+#include <limits.h>
+#include "heuristic.h"
+
+///////////////////////////////////////////////////////////////////
+// 函	数：MyHeuristic
+// 作	用：构造函数
+// 参	数：void
+///////////////////////////////////////////////////////////////////
+MyHeuristic::MyHeuristic()
+{
+    m_pGrid = NULL;
+    m_nMode = HEURISTIC_MANHATTAN;
+    m_nLandmarks = 0;
+    m_pLandmark = NULL;
+    m_pMinDist = NULL;
+    m_nCapacity = 0;
+}
+
+///////////////////////////////////////////////////////////////////
+// 函	数：~MyHeuristic
+// 作	用：析构函数
+///////////////////////////////////////////////////////////////////
+MyHeuristic::~MyHeuristic()
+{
+    free(m_pLandmark);
+    free(m_pMinDist);
+}
+
+///////////////////////////////////////////////////////////////////
+// 函	数：reserve
+// 作	用：预先申请nSize个格子的缓冲区（只增不减）
+// 参	数：int nSize		格子数
+// 返	回：bool		内存申请失败返回假
+///////////////////////////////////////////////////////////////////
+bool MyHeuristic::reserve(int nSize)
+{
+    if (nSize <= m_nCapacity)
+    {
+        return true;
+    }
+    free(m_pLandmark);
+    free(m_pMinDist);
+    m_pLandmark = (int*)malloc((size_t)nSize * MAX_LANDMARK * sizeof(int));
+    m_pMinDist = (int*)malloc(nSize * sizeof(int));
+    if ((NULL == m_pLandmark) || (NULL == m_pMinDist))
+    {
+        m_nCapacity = 0;
+        return false;
+    }
+    m_nCapacity = nSize;
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////
+// 函	数：prepare
+// 作	用：为一张地图准备估价。ALT方式下用最远点法选取地标：第一个地标
+//			为离源点最远的格子，之后每个地标为离已选地标最远的格子
+// 参	数：const MyGrid& grid	棋盘
+// 参	数：int nSourceCell		源点格子下标（用于选取第一个地标）
+// 参	数：int nMode			估价方式
+// 参	数：DialSearch& dial		用于计算代价场的搜索引擎
+// 返	回：bool		内存申请失败返回假
+///////////////////////////////////////////////////////////////////
+bool MyHeuristic::prepare(const MyGrid& grid, int nSourceCell, int nMode, DialSearch& dial)
+{
+    int nSize = grid.size();
+    int nNext = nSourceCell;
+
+    m_pGrid = &grid;
+    m_nMode = nMode;
+    m_nLandmarks = 0;
+    if (HEURISTIC_ALT != nMode)
+    {
+        return true;
+    }
+    if (!reserve(nSize))
+    {
+        m_nMode = HEURISTIC_MANHATTAN;
+        return false;
+    }
+    for (int i = 0; i < nSize; i++)
+    {
+        m_pMinDist[i] = INT_MAX;
+    }
+    // 离源点最远的格子作为第一个地标
+    if (!dial.run(grid, nSourceCell))
+    {
+        m_nMode = HEURISTIC_MANHATTAN;
+        return false;
+    }
+    for (int i = 0, nFar = -1; i < nSize; i++)
+    {
+        if ((INT_MAX != dial.distance(i)) && (dial.distance(i) > nFar))
+        {
+            nFar = dial.distance(i);
+            nNext = i;
+        }
+    }
+
+    for (int l = 0; l < MAX_LANDMARK; l++)
+    {
+        int nFar = 0;
+        if (!dial.run(grid, nNext))
+        {
+            m_nMode = HEURISTIC_MANHATTAN;
+            return false;
+        }
+        m_nLandmarks++;
+        for (int i = 0; i < nSize; i++)
+        {
+            int nDist = dial.distance(i);
+            m_pLandmark[(size_t)i * MAX_LANDMARK + l] = nDist;
+            if (nDist < m_pMinDist[i])
+            {
+                m_pMinDist[i] = nDist;
+            }
+        }
+        // 离已选地标最远的格子作为下一个地标
+        for (int i = 0; i < nSize; i++)
+        {
+            if ((INT_MAX != m_pMinDist[i]) && (m_pMinDist[i] > nFar))
+            {
+                nFar = m_pMinDist[i];
+                nNext = i;
+            }
+        }
+        if (0 == nFar)
+        {
+            // 可达区域已全部成为地标
+            break;
+        }
+    }
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////
+// 函	数：estimate
+// 作	用：格子(x, y)到目标(gx, gy)的代价下界
+// 参	数：int x, int y		节点坐标
+// 参	数：int gx, int gy	目标坐标
+// 返	回：int		返回hAstar值
+///////////////////////////////////////////////////////////////////
+int MyHeuristic::estimate(int x, int y, int gx, int gy) const
+{
+    int nBest = abs(gx - x) + abs(gy - y);
+    if (0 == m_nLandmarks)
+    {
+        return nBest;
+    }
+    int nCell = m_pGrid->cell(x, y);
+    int nGoal = m_pGrid->cell(gx, gy);
+    const int* pN = m_pLandmark + (size_t)nCell * MAX_LANDMARK;
+    const int* pG = m_pLandmark + (size_t)nGoal * MAX_LANDMARK;
+    for (int l = 0; l < m_nLandmarks; l++)
+    {
+        if ((INT_MAX == pN[l]) || (INT_MAX == pG[l]))
+        {
+            // 与地标不连通，该地标不提供下界
+            continue;
+        }
+        int nForward = pG[l] - pN[l];
+        int nBackward = pN[l] - pG[l] - m_pGrid->cost(nCell) + m_pGrid->cost(nGoal);
+        if (nForward > nBest)
+        {
+            nBest = nForward;
+        }
+        if (nBackward > nBest)
+        {
+            nBest = nBackward;
+        }
+    }
+    return nBest;
+}
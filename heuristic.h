@@ -0,0 +1,60 @@
+///////////////////////////////////////////////////////////////////
+// 文	件：heuristic.h
+// 功	能：A*算法的hAstar估价子系统
+//	曼哈顿距离：每步代价至少为1，四连通棋盘上是一致（consistent）的
+//			下界，作为基准估价
+//	ALT估价：	每张地图预先选取若干地标L，用Dial单源搜索求出地标到所有
+//			格子的代价d(L, x)，由三角不等式得到节点n到目标t的下界：
+//				d(n, t) >= d(L, t) - d(L, n)
+//				d(n, t) >= d(n, L) - d(t, L)
+//			（进入格子计代价，反向代价d(x, L) = d(L, x) + c(L) - c(x)）
+//			地标每张地图只计算一次，所有点对的A*搜索共享。
+//			估价一致，A*不会把CLOSED中的节点重新放回OPEN。
+// 作	者：gengjian1203
+// 邮	箱：gengjian1203@foxmail.com
+///////////////////////////////////////////////////////////////////
+#ifndef ORIENTEERING_HEURISTIC_H
+#define ORIENTEERING_HEURISTIC_H
+
+#include "grid.h"
+#include "search.h"
+
+// 估价方式
+#define HEURISTIC_MANHATTAN 0
+#define HEURISTIC_ALT 1
+// 最多地标个数
+#define MAX_LANDMARK 4
+
+class MyHeuristic
+{
+public:
+    MyHeuristic();
+    ~MyHeuristic();
+    // 预先申请nSize个格子的缓冲区（之后不超过该规模的地图不再申请内存）
+    bool reserve(int nSize);
+    // 为一张地图准备估价（ALT方式下选取地标并计算代价场）
+    bool prepare(const MyGrid& grid, int nSourceCell, int nMode, DialSearch& dial);
+    // 格子(x, y)到目标(gx, gy)的代价下界
+    int estimate(int x, int y, int gx, int gy) const;
+    // 当前使用的地标个数
+    int landmarkCount() const { return m_nLandmarks; }
+
+private:
+    // 当前地图
+    const MyGrid* m_pGrid;
+    // 估价方式
+    int m_nMode;
+    // 地标个数
+    int m_nLandmarks;
+    // 各格子到各地标的代价（下标为cell * MAX_LANDMARK + l，不可达为INT_MAX）
+    int* m_pLandmark;
+    // 选取地标用：各格子到已选地标的最小代价
+    int* m_pMinDist;
+    // 已申请的格子数（只增不减，重复使用）
+    int m_nCapacity;
+
+    MyHeuristic(const MyHeuristic&);
+    MyHeuristic& operator=(const MyHeuristic&);
+};
+
+#endif
@@ -0,0 +1,809 @@
+///////////////////////////////////////////////////////////////////
+// 文	件：main.cpp
+// 功	能：Orienteering命令行程序，基于liborienteering.a。
+//			负责读取地图文件、输出结果，以及多地图的批量并行求解；
+//			求解本身全部通过orienteering.h中的接口完成。
+// 作	者：gengjian1203
+// 邮	箱：gengjian1203@foxmail.com
+///////////////////////////////////////////////////////////////////
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include "orienteering.h"
+
+// 命令行一次最多查询的预算个数
+#define MAX_BUDGET 64
+
+///////////////////////////////////////////////////////////////////
+// 函	数：readChessFile
+// 作	用：将地图文件整体读入内存
+// 参	数：const char* pszFile	地图文件名
+// 参	数：size_t* pnLength		输出文件长度（可为NULL）
+// 返	回：char*		返回以'\0'结尾的文件内容（由调用者free），失败返回NULL
+///////////////////////////////////////////////////////////////////
+static char* readChessFile(const char* pszFile, size_t* pnLength)
+{
+    FILE* fp = 0x00;
+    char* pszText = NULL;
+    long nSize;
+    fp = fopen(pszFile, "rb");
+    if (0x00 == fp)
+    {
+        return NULL;
+    }
+    if ((0 != fseek(fp, 0, SEEK_END)) || (0 > (nSize = ftell(fp))) || (0 != fseek(fp, 0, SEEK_SET)))
+    {
+        fclose(fp);
+        return NULL;
+    }
+    pszText = (char*)malloc(nSize + 1);
+    if (NULL != pszText)
+    {
+        nSize = (long)fread(pszText, 1, nSize, fp);
+        pszText[nSize] = '\0';
+        if (NULL != pnLength)
+        {
+            *pnLength = (size_t)nSize;
+        }
+    }
+    fclose(fp);
+    return pszText;
+}
+
+///////////////////////////////////////////////////////////////////
+// 函	数：showStatus
+// 作	用：输出错误码对应的错误信息
+// 参	数：int nStatus		错误码
+// 返	回：void
+///////////////////////////////////////////////////////////////////
+static void showStatus(int nStatus)
+{
+    switch (nStatus)
+    {
+    case ORIENT_ERR_SIZE_LINE:
+        printf("The width or height is error.\n");
+        break;
+    case ORIENT_ERR_WIDTH:
+        printf("width is error.(1 <= width <= %d)\n", MAX_WIDTH);
+        break;
+    case ORIENT_ERR_HEIGHT:
+        printf("height is error.(1 <= height <= %d)\n", MAX_HEIGHT);
+        break;
+    case ORIENT_ERR_MAP_DATA:
+        printf("Get map data error.\n");
+        break;
+    case ORIENT_ERR_MULTI_START:
+        printf("'S' has exceeded the maximum limit.(max:1)\n");
+        break;
+    case ORIENT_ERR_MULTI_GOAL:
+        printf("'G' has exceeded the maximum limit.(max:1)\n");
+        break;
+    case ORIENT_ERR_MULTI_CHECK:
+        printf("'@' has exceeded the maximum limit.(max:%d)\n", MAX_CHECK);
+        break;
+    case ORIENT_ERR_ILLEGAL_CHAR:
+        printf("The discovery of illegal characters.\n");
+        break;
+    case ORIENT_ERR_NO_START:
+        printf("Did not find 'S'.\n");
+        break;
+    case ORIENT_ERR_NO_GOAL:
+        printf("Did not find 'G'.\n");
+        break;
+    case ORIENT_ERR_MEMORY:
+        printf("Out of memory.\n");
+        break;
+    case ORIENT_ERR_UNREACHABLE:
+        // 如果发现只要存在两点无法相通，则该题无解，返回-1
+        printf("-1\n");
+        break;
+    case ORIENT_ERR_STATE:
+        printf("This mode can not solve the current map.\n");
+        break;
+    default:
+        break;
+    }
+}
+
+///////////////////////////////////////////////////////////////////
+// 函	数：showDebug
+// 作	用：输出调试信息
+// 参	数：const Orienteering& o	求解上下文
+// 返	回：void
+///////////////////////////////////////////////////////////////////
+static void showDebug(const Orienteering& o)
+{
+    printf("\n");
+    printf("W:%d, H:%d\n", o.width(), o.height());
+    for (int i = 0; i < o.height(); i++)
+    {
+        for (int j = 0; j < o.width(); j++)
+        {
+            printf("%c", o.chessRow(i)[j]);
+        }
+        printf("\n");
+    }
+    printf("Start Point:(%d, %d)\n", o.point(0).x, o.point(0).y);
+    printf("Goal Point:(%d, %d)\n", o.point(1).x, o.point(1).y);
+    if (o.isLarge())
+    {
+        // 大点集模式只输出点数，不输出距离矩阵
+        printf("Check Points:%d\n", o.largePointCount() - 2);
+        return;
+    }
+    for (int k = 2; k < o.pointCount(); k++)
+    {
+        printf("Check Point%d:(%d, %d)\n", k, o.point(k).x, o.point(k).y);
+    }
+
+    for (int i = 0; i < o.pointCount(); i++)
+    {
+        for (int j = 0; j < o.pointCount(); j++)
+        {
+            // 惰性矩阵中尚未精确计算的点对为下界，以'~'标出
+            printf(o.isExact(i, j) ? "%d|" : "~%d|", o.distance(i, j));
+        }
+        printf("\n");
+    }
+    if ((ENGINE_BFS == o.engine()) && !o.isWeighted())
+    {
+        printf("BFS threads:%d active:%d levels:%d (parallel:%d, bottom-up:%d)\n", o.bfs().threads(),
+            o.bfs().activeThreads(), o.bfs().levelCount(),
+            o.bfs().parallelLevelCount(), o.bfs().bottomUpLevelCount());
+    }
+    else if (ENGINE_GRAPH == o.engine())
+    {
+        printf("Graph nodes:%d edges:%d (cells:%d, pruned:%d)\n", o.graph().nodeCount(), o.graph().edgeCount(),
+            o.graph().cellCount(), o.graph().prunedCount());
+    }
+    else if (!o.isWeighted() && !o.isLazy())
+    {
+        printf("A* expanded nodes:%d (landmarks:%d)\n", o.expandCount(), o.landmarkCount());
+    }
+}
+
+///////////////////////////////////////////////////////////////////
+// 函	数：showRoute
+// 作	用：输出节点访问顺序
+// 参	数：const int nRoute[]	节点索引序列
+// 参	数：int nCount		序列长度
+// 返	回：void
+///////////////////////////////////////////////////////////////////
+static void showRoute(const int nRoute[], int nCount)
+{
+    for (int i = 0; i < nCount; i++)
+    {
+        printf("%s%d", (0 == i) ? "" : "->", nRoute[i]);
+    }
+    printf("\n");
+}
+
+///////////////////////////////////////////////////////////////////
+// 函	数：runSingle
+// 作	用：求解一张地图并输出调试信息和结果
+// 参	数：Orienteering& o		求解上下文
+// 参	数：const char* pszFile	地图文件名
+// 参	数：const int* pnBudget	奖励收集模式的步数预算（nBudgetCount为0时为哈密顿模式）
+// 参	数：int nBudgetCount		预算个数
+// 参	数：int nKBest		大于1时输出前nKBest条最短路径
+// 参	数：bool bAllGoals		为真时另外输出终点任意的最短路径
+// 返	回：void
+///////////////////////////////////////////////////////////////////
+static void runSingle(Orienteering& o, const char* pszFile, const int* pnBudget, int nBudgetCount, int nKBest, bool bAllGoals)
+{
+    size_t nLength = 0;
+    int nStatus;
+    // 通过地图文件中的信息建图
+    char* pszText = readChessFile(pszFile, &nLength);
+    if (NULL == pszText)
+    {
+        printf("Can not open file.\n");
+        return;
+    }
+    nStatus = o.loadMap(pszText, nLength);
+    free(pszText);
+    if (ORIENT_OK != nStatus)
+    {
+        // 数据非法则直接返回
+        showStatus(nStatus);
+        return;
+    }
+    // 算出任意两点之间的最短距离，构成解决哈密顿最短路径的权重矩阵
+    nStatus = o.buildMatrix();
+    if (ORIENT_OK != nStatus)
+    {
+        showStatus(nStatus);
+        return;
+    }
+    // 如果发现点点相通，再进行最短路径运算
+    showDebug(o);
+    if ((0 < nBudgetCount) && o.isLarge())
+    {
+        // 大点集的奖励收集模式：每个预算贪心插入一次
+        int nRoute[MAX_LARGE_POINT];
+        OrientTour tour;
+        tour.pRoute = nRoute;
+        tour.nCapacity = MAX_LARGE_POINT;
+        for (int b = 0; b < nBudgetCount; b++)
+        {
+            int nScore = -1;
+            nStatus = o.solvePrizeTour(pnBudget[b], &tour, &nScore);
+            if (ORIENT_OK != nStatus)
+            {
+                showStatus(nStatus);
+                return;
+            }
+            printf("Budget:%d Score:%d Steps:%d Route:", pnBudget[b], nScore, tour.nSteps);
+            showRoute(tour.pRoute, tour.nCount);
+        }
+        return;
+    }
+    if (0 < nBudgetCount)
+    {
+        // 奖励收集模式：一次运算回答所有预算
+        OrientPrize prize[MAX_BUDGET];
+        nStatus = o.solvePrize(pnBudget, nBudgetCount, prize);
+        if (ORIENT_OK != nStatus)
+        {
+            showStatus(nStatus);
+            return;
+        }
+        for (int b = 0; b < nBudgetCount; b++)
+        {
+            printf("Budget:%d Score:%d Steps:%d Route:", prize[b].nBudget, prize[b].nScore, prize[b].nSteps);
+            showRoute(prize[b].nRoute, prize[b].nCount);
+        }
+        return;
+    }
+    if (1 < nKBest)
+    {
+        // k条最短路径：一次DP得到最优路径及备选路径
+        OrientPath kPath[KBEST_MAX];
+        int nCount = 0;
+        nStatus = o.solveKBest(nKBest, kPath, &nCount);
+        if (ORIENT_OK != nStatus)
+        {
+            showStatus(nStatus);
+            return;
+        }
+        printf("K-best table:%lu bytes\n", (unsigned long)o.kBestMemory());
+        for (int r = 0; r < nCount; r++)
+        {
+            printf("Rank:%d Steps:%d Route:", r + 1, kPath[r].nSteps);
+            showRoute(kPath[r].nRoute, kPath[r].nCount);
+        }
+        return;
+    }
+    if (o.isLarge())
+    {
+        // 大点集模式：分簇求解
+        int nRoute[MAX_LARGE_POINT];
+        OrientTour tour;
+        tour.pRoute = nRoute;
+        tour.nCapacity = MAX_LARGE_POINT;
+        nStatus = o.solveTour(&tour);
+        if (ORIENT_OK != nStatus)
+        {
+            showStatus(nStatus);
+            return;
+        }
+        printf("Clusters:%d, repair gain:%d\n", o.clusterCount(), o.repairGain());
+        printf("So.The result of steps away:%d\n", tour.nSteps);
+        printf("Route:");
+        showRoute(tour.pRoute, tour.nCount);
+        return;
+    }
+    OrientPath path;
+    nStatus = o.solvePath(&path);
+    if (ORIENT_OK != nStatus)
+    {
+        showStatus(nStatus);
+        return;
+    }
+    if (o.isLazy())
+    {
+        printf("Lazy matrix: exact searches:%d, branch-and-bound nodes:%d, A* expanded nodes:%d\n",
+            o.exactSearchCount(), o.boundNodeCount(), o.expandCount());
+    }
+    printf("So.The result of steps away:%d\n", path.nSteps);
+    printf("Route:");
+    showRoute(path.nRoute, path.nCount);
+    if (bAllGoals)
+    {
+        // 同一DP表查询所有终点，取步数最少的终点
+        OrientPath allPath[MAX_POINT];
+        int nBest = 0;
+        o.solveAllGoals(allPath, &nBest);
+        printf("Any end point:%d steps:%d Route:", nBest, allPath[nBest].nSteps);
+        showRoute(allPath[nBest].nRoute, allPath[nBest].nCount);
+    }
+}
+
+///////////////////////////////////////////////////////////////////
+// 函	数：solveText
+// 作	用：静默求解内存中的一张地图（供批量运算使用）
+// 参	数：Orienteering& o		求解上下文（可重复使用）
+// 参	数：const char* pszText	地图文本（NULL表示读取失败）
+// 参	数：size_t nLength		文本长度
+// 返	回：int		返回S经过所有'@'到G的最短步数，无解或非法返回-1
+///////////////////////////////////////////////////////////////////
+static int solveText(Orienteering& o, const char* pszText, size_t nLength)
+{
+    OrientPath path;
+    if ((NULL == pszText) || (ORIENT_OK != o.loadMap(pszText, nLength)) || (ORIENT_OK != o.buildMatrix()))
+    {
+        return -1;
+    }
+    if (o.isLarge())
+    {
+        int nRoute[MAX_LARGE_POINT];
+        OrientTour tour;
+        tour.pRoute = nRoute;
+        tour.nCapacity = MAX_LARGE_POINT;
+        return (ORIENT_OK == o.solveTour(&tour)) ? tour.nSteps : -1;
+    }
+    if (ORIENT_OK != o.solvePath(&path))
+    {
+        return -1;
+    }
+    return path.nSteps;
+}
+
+///////////////////////////////////////////////////////////////////
+// 批量运算阶段
+// 每个工作线程拥有一个可重复使用的Orienteering求解上下文；任务按
+// 输入顺序轮流分配到各线程的双端队列，线程从队首取自己的任务，空闲
+// 时从其他线程队尾窃取任务，避免个别大地图拖慢整体；读取线程按输入
+// 顺序提前读入地图文件，只有文件读取与求解重叠，解析地图（loadMap）
+// 仍在求解该地图的工作线程上进行；结果按输入顺序输出。
+///////////////////////////////////////////////////////////////////
+struct MyBatchTask
+{
+    // 地图文件名
+    const char* pszFile;
+    // 地图文本（读取线程填入，求解后释放）
+    char* pszText;
+    size_t nLength;
+    // 是否已读入
+    bool bLoaded;
+    // 是否已求解
+    bool bDone;
+    // 求解结果
+    int nResult;
+
+};
+
+class BatchScheduler
+{
+public:
+    BatchScheduler(int nThreads, int nLayout, int nEngine, int nBfsThreads, bool bLazy, bool bLarge);
+    ~BatchScheduler();
+    // 批量求解，结果按输入顺序输出到stdout
+    void run(const char* const* ppszFile, int nCount);
+
+private:
+    // 工作线程数
+    int m_nThreads;
+    // 任务信息
+    MyBatchTask* m_pTask;
+    int m_nTaskCount;
+    // 每个线程的求解上下文（约2M的DP表，重复使用）
+    Orienteering** m_ppSolver;
+    // 每个线程的任务双端队列
+    std::deque<int>* m_pQueue;
+    std::mutex* m_pQueueLock;
+    // 读取/输出状态
+    std::mutex m_lock;
+    std::condition_variable m_cvLoaded;
+    std::condition_variable m_cvWindow;
+    // 已读入但尚未求解的任务数（不超过m_nWindow）
+    int m_nInFlight;
+    int m_nWindow;
+    // 下一个待输出的任务
+    int m_nNextPrint;
+
+private:
+    // 读取线程主流程
+    void loaderMain();
+    // 工作线程主流程
+    void workerMain(int nWorker);
+    // 取得下一个任务（先取自己的队首，再窃取其他线程的队尾）
+    int takeTask(int nWorker);
+    // 任务完成，按输入顺序输出已完成的结果
+    void finishTask(int nTask, int nResult);
+};
+
+///////////////////////////////////////////////////////////////////
+// 函	数：BatchScheduler
+// 作	用：构造函数，为每个工作线程创建求解上下文
+// 参	数：int nThreads		工作线程数
+// 参	数：int nLayout		棋盘存储顺序
+// 参	数：int nEngine		阶段1的距离计算引擎
+// 参	数：int nBfsThreads	每个求解上下文的BFS及簇内求解线程数（含工作线程本身）
+// 参	数：bool bLazy		是否使用惰性距离矩阵
+// 参	数：bool bLarge		是否使用大点集模式
+///////////////////////////////////////////////////////////////////
+BatchScheduler::BatchScheduler(int nThreads, int nLayout, int nEngine, int nBfsThreads, bool bLazy, bool bLarge)
+{
+    m_nThreads = (1 > nThreads) ? 1 : nThreads;
+    m_pTask = NULL;
+    m_nTaskCount = 0;
+    m_ppSolver = new Orienteering*[m_nThreads];
+    for (int i = 0; i < m_nThreads; i++)
+    {
+        m_ppSolver[i] = new Orienteering();
+        m_ppSolver[i]->setGridLayout(nLayout);
+        m_ppSolver[i]->setEngine(nEngine);
+        m_ppSolver[i]->setThreads(nBfsThreads);
+        m_ppSolver[i]->setLazyMatrix(bLazy);
+        m_ppSolver[i]->setLargeMode(bLarge);
+    }
+    m_pQueue = new std::deque<int>[m_nThreads];
+    m_pQueueLock = new std::mutex[m_nThreads];
+    m_nInFlight = 0;
+    m_nWindow = 4 * m_nThreads;
+    m_nNextPrint = 0;
+}
+
+///////////////////////////////////////////////////////////////////
+// 函	数：~BatchScheduler
+// 作	用：析构函数
+///////////////////////////////////////////////////////////////////
+BatchScheduler::~BatchScheduler()
+{
+    for (int i = 0; i < m_nThreads; i++)
+    {
+        delete m_ppSolver[i];
+    }
+    delete[] m_ppSolver;
+    delete[] m_pQueue;
+    delete[] m_pQueueLock;
+}
+
+///////////////////////////////////////////////////////////////////
+// 函	数：loaderMain
+// 作	用：读取线程主流程，按输入顺序读入地图文件，最多提前m_nWindow个
+//			（工作线程总是先取自己队列中序号最小的任务，因此等待读入的
+//			线程手中不会压着已读入的任务，窗口不会死锁）
+// 参	数：void
+// 返	回：void
+///////////////////////////////////////////////////////////////////
+void BatchScheduler::loaderMain()
+{
+    for (int i = 0; i < m_nTaskCount; i++)
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_lock);
+            while (m_nInFlight >= m_nWindow)
+            {
+                m_cvWindow.wait(lock);
+            }
+        }
+        size_t nLength = 0;
+        char* pszText = readChessFile(m_pTask[i].pszFile, &nLength);
+        std::lock_guard<std::mutex> lock(m_lock);
+        m_pTask[i].pszText = pszText;
+        m_pTask[i].nLength = nLength;
+        m_pTask[i].bLoaded = true;
+        m_nInFlight++;
+        m_cvLoaded.notify_all();
+    }
+}
+
+///////////////////////////////////////////////////////////////////
+// 函	数：takeTask
+// 作	用：取得下一个任务（先取自己的队首，再窃取其他线程的队尾）
+// 参	数：int nWorker		工作线程编号
+// 返	回：int		返回任务序号，没有任务返回-1
+///////////////////////////////////////////////////////////////////
+int BatchScheduler::takeTask(int nWorker)
+{
+    int nTask = -1;
+    {
+        std::lock_guard<std::mutex> lock(m_pQueueLock[nWorker]);
+        if (!m_pQueue[nWorker].empty())
+        {
+            nTask = m_pQueue[nWorker].front();
+            m_pQueue[nWorker].pop_front();
+            return nTask;
+        }
+    }
+    for (int i = 1; i < m_nThreads; i++)
+    {
+        int nVictim = (nWorker + i) % m_nThreads;
+        std::lock_guard<std::mutex> lock(m_pQueueLock[nVictim]);
+        if (!m_pQueue[nVictim].empty())
+        {
+            nTask = m_pQueue[nVictim].back();
+            m_pQueue[nVictim].pop_back();
+            return nTask;
+        }
+    }
+    return -1;
+}
+
+///////////////////////////////////////////////////////////////////
+// 函	数：finishTask
+// 作	用：任务完成，按输入顺序输出所有已完成的结果
+// 参	数：int nTask		任务序号
+// 参	数：int nResult		求解结果
+// 返	回：void
+///////////////////////////////////////////////////////////////////
+void BatchScheduler::finishTask(int nTask, int nResult)
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    free(m_pTask[nTask].pszText);
+    m_pTask[nTask].pszText = NULL;
+    m_pTask[nTask].nResult = nResult;
+    m_pTask[nTask].bDone = true;
+    m_nInFlight--;
+    m_cvWindow.notify_one();
+    while ((m_nNextPrint < m_nTaskCount) && m_pTask[m_nNextPrint].bDone)
+    {
+        printf("%s %d\n", m_pTask[m_nNextPrint].pszFile, m_pTask[m_nNextPrint].nResult);
+        m_nNextPrint++;
+    }
+}
+
+///////////////////////////////////////////////////////////////////
+// 函	数：workerMain
+// 作	用：工作线程主流程
+// 参	数：int nWorker		工作线程编号
+// 返	回：void
+///////////////////////////////////////////////////////////////////
+void BatchScheduler::workerMain(int nWorker)
+{
+    int nTask;
+    while (-1 != (nTask = takeTask(nWorker)))
+    {
+        const char* pszText;
+        size_t nLength;
+        {
+            // 等待读取线程读入该地图
+            std::unique_lock<std::mutex> lock(m_lock);
+            while (!m_pTask[nTask].bLoaded)
+            {
+                m_cvLoaded.wait(lock);
+            }
+            pszText = m_pTask[nTask].pszText;
+            nLength = m_pTask[nTask].nLength;
+        }
+        finishTask(nTask, solveText(*m_ppSolver[nWorker], pszText, nLength));
+    }
+}
+
+///////////////////////////////////////////////////////////////////
+// 函	数：run
+// 作	用：批量求解，结果按输入顺序输出到stdout（每行“文件名 步数”）
+// 参	数：const char* const* ppszFile	地图文件名数组
+// 参	数：int nCount		地图文件个数
+// 返	回：void
+///////////////////////////////////////////////////////////////////
+void BatchScheduler::run(const char* const* ppszFile, int nCount)
+{
+    m_nTaskCount = nCount;
+    m_pTask = new MyBatchTask[nCount];
+    m_nInFlight = 0;
+    m_nNextPrint = 0;
+    for (int i = 0; i < nCount; i++)
+    {
+        m_pTask[i].pszFile = ppszFile[i];
+        m_pTask[i].pszText = NULL;
+        m_pTask[i].nLength = 0;
+        m_pTask[i].bLoaded = false;
+        m_pTask[i].bDone = false;
+        m_pTask[i].nResult = -1;
+        // 按输入顺序轮流分配，各队列内序号递增
+        m_pQueue[i % m_nThreads].push_back(i);
+    }
+
+    std::thread loader(&BatchScheduler::loaderMain, this);
+    std::thread* pWorker = new std::thread[m_nThreads];
+    for (int i = 0; i < m_nThreads; i++)
+    {
+        pWorker[i] = std::thread(&BatchScheduler::workerMain, this, i);
+    }
+    for (int i = 0; i < m_nThreads; i++)
+    {
+        pWorker[i].join();
+    }
+    loader.join();
+    delete[] pWorker;
+    delete[] m_pTask;
+    m_pTask = NULL;
+}
+
+///////////////////////////////////////////////////////////////////
+// 函	数：readListFile
+// 作	用：读取地图列表文件（每行一个地图文件名）
+// 参	数：const char* pszFile	列表文件名
+// 参	数：char** ppszText		输出列表缓冲区（由调用者free）
+// 参	数：int* pnCount		输出文件名个数
+// 返	回：const char**	返回指向缓冲区内各文件名的数组（由调用者free），失败返回NULL
+///////////////////////////////////////////////////////////////////
+static const char** readListFile(const char* pszFile, char** ppszText, int* pnCount)
+{
+    char* pszText = readChessFile(pszFile, NULL);
+    const char** ppszFiles;
+    int nLines = 1;
+    if (NULL == pszText)
+    {
+        return NULL;
+    }
+    for (const char* p = pszText; '\0' != *p; p++)
+    {
+        nLines += ('\n' == *p) ? 1 : 0;
+    }
+    ppszFiles = (const char**)malloc(nLines * sizeof(const char*));
+    if (NULL == ppszFiles)
+    {
+        free(pszText);
+        return NULL;
+    }
+    *pnCount = 0;
+    for (char* pLine = strtok(pszText, "\r\n"); NULL != pLine; pLine = strtok(NULL, "\r\n"))
+    {
+        ppszFiles[(*pnCount)++] = pLine;
+    }
+    *ppszText = pszText;
+    return ppszFiles;
+}
+
+//////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////
+// 函	数：main
+// 作	用：程序主函数
+// 参	数：int argc		输入参数个数
+// 参	数：char* argv[]	命令行参数
+// 返	回：int		给操作系统返回执行情况
+///////////////////////////////////////////////////////////////////
+int main(int argc, char* argv[])
+{
+    // 用法：Orienteering [-t] [-d | -m] [-c | -p 线程数] [-a]                     求解example1.txt
+    //       Orienteering [-t] [-d | -m] [-c | -p 线程数] [-j 线程数] 地图1 地图2 ...  批量求解
+    //       Orienteering [-t] [-d | -m] [-c | -p 线程数] [-j 线程数] -l 列表文件      批量求解列表中的地图
+    //       Orienteering [-t] [-d | -m] [-c | -p 线程数] -b 预算1,预算2,...             奖励收集模式求解example1.txt
+    //       Orienteering [-t] [-d] [-c | -p 线程数] -k 路径数                          求解example1.txt的前k条最短路径（不能与-m、-b同用）
+    //       -t：棋盘使用分块存储
+    //       -c：阶段1在通道收缩图上计算距离
+    //       -p：阶段1用多线程广度优先搜索（无权地图），批量求解时每个工作线程各用这么多线程。
+    //           格子数小于BFS_SERIAL_SIZE（约256x256）的地图只用调用线程
+    //       -d：惰性距离矩阵，分支定界需要时才做精确搜索
+    //       -m：大点集模式，'@'多于MAX_CHECK时分簇求解（簇内求解线程数同-p）
+    //       -a：另外输出终点任意的最短路径（不能与-m、-b、-k、批量求解同用）
+    //       批量求解不能使用-k、-b
+    int nThreads = (int)std::thread::hardware_concurrency();
+    int nBudget[MAX_BUDGET];
+    int nBudgetCount = 0;
+    int nKBest = 1;
+    int nLayout = GRID_ROW_MAJOR;
+    int nEngine = ENGINE_GRID;
+    int nBfsThreads = 1;
+    bool bLazy = false;
+    bool bLarge = false;
+    bool bAllGoals = false;
+    const char* pszList = NULL;
+    int nFirst = 1;
+    while ((nFirst < argc) && ('-' == argv[nFirst][0]))
+    {
+        if (0 == strcmp(argv[nFirst], "-t"))
+        {
+            nLayout = GRID_TILED;
+            nFirst++;
+            continue;
+        }
+        if (0 == strcmp(argv[nFirst], "-m"))
+        {
+            bLarge = true;
+            nFirst++;
+            continue;
+        }
+        if (0 == strcmp(argv[nFirst], "-d"))
+        {
+            bLazy = true;
+            nFirst++;
+            continue;
+        }
+        if (0 == strcmp(argv[nFirst], "-c"))
+        {
+            nEngine = ENGINE_GRAPH;
+            nFirst++;
+            continue;
+        }
+        if (0 == strcmp(argv[nFirst], "-a"))
+        {
+            bAllGoals = true;
+            nFirst++;
+            continue;
+        }
+        if (nFirst + 1 >= argc)
+        {
+            break;
+        }
+        if (0 == strcmp(argv[nFirst], "-j"))
+        {
+            nThreads = atoi(argv[nFirst + 1]);
+        }
+        else if (0 == strcmp(argv[nFirst], "-p"))
+        {
+            nEngine = ENGINE_BFS;
+            nBfsThreads = atoi(argv[nFirst + 1]);
+        }
+        else if (0 == strcmp(argv[nFirst], "-l"))
+        {
+            pszList = argv[nFirst + 1];
+        }
+        else if (0 == strcmp(argv[nFirst], "-k"))
+        {
+            nKBest = atoi(argv[nFirst + 1]);
+        }
+        else if (0 == strcmp(argv[nFirst], "-b"))
+        {
+            for (char* pszBudget = strtok(argv[nFirst + 1], ","); (NULL != pszBudget) && (nBudgetCount < MAX_BUDGET);
+                pszBudget = strtok(NULL, ","))
+            {
+                nBudget[nBudgetCount++] = atoi(pszBudget);
+            }
+        }
+        nFirst += 2;
+    }
+    if ((1 < nKBest) && (bLarge || (0 < nBudgetCount)))
+    {
+        // k条最短路径只用于哈密顿模式的小地图
+        printf("-k can not be combined with -m or -b.\n");
+        return 1;
+    }
+    if (bAllGoals && (bLarge || (NULL != pszList) || (nFirst < argc) || (0 < nBudgetCount) || (1 < nKBest)))
+    {
+        // 终点任意只用于单张地图的哈密顿模式
+        printf("-a can not be combined with -m, -b, -k or batch mode.\n");
+        return 1;
+    }
+    if (((NULL != pszList) || (nFirst < argc)) && ((1 < nKBest) || (0 < nBudgetCount)))
+    {
+        // 批量求解只输出每张地图的最短步数
+        printf("-k and -b can not be used in batch mode.\n");
+        return 1;
+    }
+    if (NULL != pszList)
+    {
+        char* pszText = NULL;
+        int nCount = 0;
+        const char** ppszFiles = readListFile(pszList, &pszText, &nCount);
+        if (NULL == ppszFiles)
+        {
+            printf("Can not open file.\n");
+            return 1;
+        }
+        BatchScheduler batch(nThreads, nLayout, nEngine, nBfsThreads, bLazy, bLarge);
+        batch.run(ppszFiles, nCount);
+        free(ppszFiles);
+        free(pszText);
+        return 0;
+    }
+    if (nFirst < argc)
+    {
+        BatchScheduler batch(nThreads, nLayout, nEngine, nBfsThreads, bLazy, bLarge);
+        batch.run(argv + nFirst, argc - nFirst);
+        return 0;
+    }
+    // 求解上下文含约2M的DP表，放在堆上
+    Orienteering* pContext = new Orienteering();
+    Orienteering& o = *pContext;
+    o.setGridLayout(nLayout);
+    o.setEngine(nEngine);
+    o.setThreads(nBfsThreads);
+    o.setLazyMatrix(bLazy);
+    o.setLargeMode(bLarge);
+    runSingle(o, "example1.txt", nBudget, nBudgetCount, nKBest, bAllGoals);
+    delete pContext;
+    //////////////////////////////////////////////////////////////////////
+    // 调试
+    //system("pause");
+    return 0;
+}
@@ -1,8 +1,7 @@
 ///////////////////////////////////////////////////////////////////
 // 文	件：orienteering.cpp
-// 功	能：将example1.txt文件中信息读取出来，‘#’为障碍物，‘.’为可行
-//			区域，经过运算找到一个起点为‘S’，终点为‘G’，且经过所有
-//			‘@’点的最短路径
+// 功	能：定向越野求解库实现。‘#’为障碍物，‘.’为可行区域，经过运算
+//			找到一个起点为‘S’，终点为‘G’，且经过所有‘@’点的最短路径
 // 思	想：将问题分解。首先通过A*算法计算出任意两点之间的最短路径和步骤
 //			，接下来就是解决哈密顿路径问题。最后通过Floyd算法得出满足题
 //			目要求的最短路径。
@@ -11,241 +10,594 @@
 //			gAstar = 起点到达节点的实际代价值
 //			hAstar = 节点到达终点的最佳路径的估价值
 //			目标为在节点到达终点时，fAstar数值最小，即为最短路径所用步数
-//			（为简化运算，本题中hAstar的取值为两点之间的直线距离的平方）
+//			（hAstar由heuristic.h中的估价子系统给出：曼哈顿距离或ALT
+//			地标下界，两者都是一致的下界，节点不会被重复展开）
 // 待解	决：节点数最多计算15个点，无法达到题目要求的20个点
 // 作	者：gengjian1203
 // 邮	箱：gengjian1203@foxmail.com
 // 日	期：2014.10.20
 ///////////////////////////////////////////////////////////////////
-#include <stdio.h>
 #include <stdlib.h>
 #include <limits.h>
-#include <errno.h>
 #include <string.h>
+#include "orienteering.h"
 
-// 根据题干，设定以下宏
-// 1 <= width <= 100   1 <= height <= 100
-#define MAX_WIDTH 100
-#define MAX_HEIGHT 100
-// The maximum number of point is 20 (start + goal + check)
-// 15个点为内存极限 -.-!~~如在内存可以加大的情况下可将MAX_POINT宏的数加大
-// 但占用内存成几何倍数增长）
-#define MAX_POINT 15
-#define MAX_CHECK MAX_POINT - 2
-
-struct MyPoint
-{
-    // 该点属性
-    int x;
-    int y;
-
-};
-
-struct MyNode
-{
-    // 该点属性
-    MyPoint point;
-    // 该点star参数
-    int fAstar;
-    int hAstar;
-    int gAstar;
-    // 指向上一步骤行走的节点
-    MyNode* pParent;
-    // 指向链表中下个元素
-    MyNode* pNext;
-
-};
-
-class Orienteering
-{
-public:
-    void main();
-
-private:
-    // 棋盘信息-宽
-    int m_nWidth;
-    // 棋盘信息-高
-    int m_nHeight;
-    // 棋盘信息-check点个数
-    int m_nCheckCount;
-    // 棋盘信息-明细
-    char m_chess[MAX_HEIGHT][MAX_WIDTH];
-    // 棋盘信息-节点信息
-    MyPoint m_point[MAX_POINT];					// 第0元素为start，第1元素为goal，接下来一次为check point。
-    // 哈密顿路径-距离矩阵
-    int m_nHamilRect[MAX_POINT][MAX_POINT];
-    // 哈密顿路径-行走最短步数
-    int m_nDist[(1<<MAX_POINT)][MAX_POINT];		// 问题：内存申请可能过大！！！！！
-
-    MyNode* listOPEN;
-    MyNode* listCLOSED;
-
-private:
-    ///////////////////////////////////////////////////////////////////
-    // 分析可获知信息准备阶段
-    ///////////////////////////////////////////////////////////////////
-    // 输出调试信息
-    void showDebug();
-    // 创建棋盘信息数组
-    bool createChess();
-    // 分析棋盘
-    bool analyseChess();
-    ///////////////////////////////////////////////////////////////////
-    // A*算法操作阶段
-    ///////////////////////////////////////////////////////////////////
-    // 获取节点N的hAstar值
-    int gethAstar(MyPoint pointN, MyPoint pointG);
-    // 获取listOPEN表中hAstar最小的节点
-    MyNode* getBestNode();
-    // 将该点从listOPEN表移动到listCLOSED表中
-    void moveOPENtoCLOSED(MyPoint point);
-    // 将该点从listCLOSED表移动到listOPEN表中
-    void moveCLOSEDtoOPEN(MyPoint point);
-    // 判断该点是否为可行区域
-    bool isSureNode(MyPoint point);
-    // 判断该节点是否在listOPEN表中
-    MyNode* isNodeInlistOPEN(MyPoint point);
-    // 判断该节点是否在listCLOSED表中
-    MyNode* isNodeInlistCLOSED(MyPoint point);
-    // 将该节点添加到listOPEN表中
-    void inserttolistOPEN(MyNode* pInsertNode);
-    // 生成的后续节点情况处理
-    void generateList(MyNode* pParentNode, MyPoint pointChild, MyPoint pointGoal);
-    // 生成最佳节点下的子节点，填入listOPEN
-    void createChildNodeIntoOpen(MyNode *pParentNode, MyPoint pointGoal);
-    // 销毁表指定表
-    void DestroyList(MyNode *pHead);
-    // A*算法主要流程
-    int AstarMain(MyPoint pointGoal, MyPoint pointStart);
-    ///////////////////////////////////////////////////////////////////
-    // 求最短哈密顿路径阶段
-    ///////////////////////////////////////////////////////////////////
-    // 生成哈密顿路径距离矩阵m_nHamilRect
-    bool createHamilRect();
-    // 运算哈密顿Floyd
-    void hamiltonianFloyd();
-    // 求哈密顿最短路径
-    int hamiltonianPath(int nIndexS, int nIndexG);
-};
-
-///////////////////////////////////////////////////////////////////
-// 函	数：showDebug
-// 作	用：输出调试信息
+///////////////////////////////////////////////////////////////////
+// 函	数：Orienteering
+// 作	用：构造函数，按题干的最大地图（PRESET_WIDTH x PRESET_HEIGHT）预先
+//			申请棋盘及各搜索引擎的缓冲区，之后这一规模的地图载入、建矩阵时
+//			不再申请内存；更大的地图在载入时扩大（只增不减）
 // 参	数：void
-// 返	回：void
 ///////////////////////////////////////////////////////////////////
-void Orienteering::showDebug()
+Orienteering::Orienteering()
 {
-    printf("\n");
-    printf("W:%d, H:%d\n", m_nWidth, m_nHeight);
-    for (int i = 0; i < m_nHeight; i++)
+    m_nPhase = 0;
+    m_nWidth = 0;
+    m_nHeight = 0;
+    m_nCheckCount = 0;
+    m_bWeighted = false;
+    m_nDistStart = -1;
+    m_bLarge = false;
+    m_bLargeMap = false;
+    m_nLargeCount = 0;
+    m_pLargeDist = NULL;
+    m_nLargeCapacity = 0;
+    m_nThreads = 1;
+    m_pKBest = NULL;
+    m_nKBestCapacity = 0;
+    m_nKBestBytes = 0;
+    m_bLazy = false;
+    m_bLazyMatrix = false;
+    m_bLazyPrepared = false;
+    m_bLazyNoMemory = false;
+    m_nExactSearches = 0;
+    m_nBestCost = INT_MAX;
+    m_nBoundNodes = 0;
+    for (int i = 0; i < MAX_POINT; i++)
     {
-        for (int j = 0; j < m_nWidth; j++)
+        for (int j = 0; j < MAX_POINT; j++)
         {
-            printf("%c", m_chess[i][j]);
+            m_bExact[i][j] = false;
         }
-        printf("\n");
     }
-    printf("Start Point:(%d, %d)\n", m_point[0].x, m_point[0].y);
-    printf("Goal Point:(%d, %d)\n", m_point[1].x, m_point[1].y);
-    for (int k = 2; k < m_nCheckCount; k++)
+    m_nLayout = GRID_ROW_MAJOR;
+    m_nHeuristic = HEURISTIC_ALT;
+    m_nExpandCount = 0;
+    m_nEngine = ENGINE_GRID;
+    m_nScoreEntries = 0;
+    m_nFrontierCount = 0;
+    m_pChess = NULL;
+    m_nChessCapacity = 0;
+    m_pNodePool = NULL;
+    m_nNodeCapacity = 0;
+    m_nNodeCount = 0;
+    listOPEN = NULL;
+    listCLOSED = NULL;
+    reserveChess(PRESET_WIDTH * PRESET_HEIGHT);
+    reserveNodePool(PRESET_WIDTH * PRESET_HEIGHT);
+    // 分块存储补齐后的格子数不小于行优先，按分块预留即可覆盖两种存储顺序
+    if (m_grid.create(PRESET_WIDTH, PRESET_HEIGHT, GRID_TILED))
     {
-        printf("Check Point%d:(%d, %d)\n", k, m_point[k].x, m_point[k].y);
+        m_dial.reserve(m_grid.size());
+        m_heuristic.reserve(m_grid.size());
+        m_graph.reserve(m_grid.size());
+        m_bfs.reserve(m_grid.size());
     }
+}
 
-    for (int i = 0; i < m_nCheckCount; i++)
+///////////////////////////////////////////////////////////////////
+// 函	数：~Orienteering
+// 作	用：析构函数
+///////////////////////////////////////////////////////////////////
+Orienteering::~Orienteering()
+{
+    free(m_pChess);
+    free(m_pNodePool);
+    free(m_pLargeDist);
+    free(m_pKBest);
+}
+
+///////////////////////////////////////////////////////////////////
+// 函	数：loadMap
+// 作	用：由内存中的地图文本建图（首行为“宽,高”，也接受“宽 高”；
+//			地图之后可选“x,y,分值”行，为奖励收集模式指定'@'的分值）
+// 参	数：const char* pszText	地图文本（不要求以'\0'结尾）
+// 参	数：size_t nLength		文本长度
+// 返	回：int		ORIENT_OK或错误码
+///////////////////////////////////////////////////////////////////
+int Orienteering::loadMap(const char* pszText, size_t nLength)
+{
+    int nStatus;
+    m_nPhase = 0;
+    m_nDistStart = -1;
+    if (NULL == pszText)
     {
-        for (int j = 0; j < m_nCheckCount; j++)
+        return ORIENT_ERR_SIZE_LINE;
+    }
+    nStatus = createChess(pszText, pszText + nLength);
+    if (ORIENT_OK == nStatus)
+    {
+        nStatus = analyseChess();
+    }
+    if (ORIENT_OK == nStatus)
+    {
+        m_nPhase = 1;
+    }
+    return nStatus;
+}
+
+///////////////////////////////////////////////////////////////////
+// 函	数：buildMatrix
+// 作	用：阶段1：计算所有点之间的最短距离矩阵
+// 参	数：void
+// 返	回：int		ORIENT_OK或错误码（存在两点不通为ORIENT_ERR_UNREACHABLE）
+///////////////////////////////////////////////////////////////////
+int Orienteering::buildMatrix()
+{
+    int nStatus;
+    if (1 > m_nPhase)
+    {
+        return ORIENT_ERR_STATE;
+    }
+    m_nPhase = 1;
+    m_nDistStart = -1;
+    m_bLazyMatrix = m_bLazy && !m_bLargeMap;
+    if (m_bLargeMap)
+    {
+        nStatus = createLargeRect();
+        m_nPhase = (ORIENT_OK == nStatus) ? 2 : 1;
+        return nStatus;
+    }
+    // 无权地图逐格搜索用A*，节点池按格子数准备（只增不减）
+    if ((ENGINE_GRID == m_nEngine) && !m_bWeighted && !reserveNodePool(m_nWidth * m_nHeight))
+    {
+        return ORIENT_ERR_MEMORY;
+    }
+    if (m_bLazyMatrix)
+    {
+        // 惰性矩阵：只填下界，不通的点对在求解时才会发现
+        createLazyRect();
+        m_nPhase = 2;
+        return ORIENT_OK;
+    }
+    nStatus = createHamilRect();
+    if (ORIENT_OK == nStatus)
+    {
+        for (int i = 0; i < m_nCheckCount; i++)
         {
-            printf("%d|", m_nHamilRect[i][j]);
+            for (int j = 0; j < m_nCheckCount; j++)
+            {
+                m_bExact[i][j] = true;
+            }
         }
-        printf("\n");
+        m_nPhase = 2;
     }
+    return nStatus;
 }
 
 ///////////////////////////////////////////////////////////////////
-// 函	数：createChess
-// 作	用：创建棋盘信息数组
-// 参	数：void
-// 返	回：bool		返回创建的棋盘信息是否合法
+// 函	数：solvePath
+// 作	用：阶段2：S经过所有'@'到达G的最短路径
+// 参	数：OrientPath* pPath	输出路径
+// 返	回：int		ORIENT_OK或错误码
 ///////////////////////////////////////////////////////////////////
-bool Orienteering::createChess()
+int Orienteering::solvePath(OrientPath* pPath)
 {
-    FILE* fp = 0x00;
-    char ln[MAX_WIDTH];
-    fp = fopen("example1.txt", "r");
-    if (0x00 == fp)
+    if ((2 > m_nPhase) || m_bLargeMap)
     {
-        printf("Can not open file.\n");
-        return false;
+        return ORIENT_ERR_STATE;
+    }
+    if (m_bLazyMatrix)
+    {
+        // 惰性矩阵：在当前矩阵（精确值与下界混合）上分支定界求最优路径，
+        // 只对路径上尚未精确的边做精确搜索，直到最优路径的边全部精确。
+        // 此时其他路径按矩阵算出的步数都是其真实步数的下界，且不小于该路径
+        m_nBoundNodes = 0;
+        m_nBestCost = INT_MAX;
+        while (true)
+        {
+            // 上一轮的最优路径按更新后的矩阵重新计算，作为初始上界
+            if (INT_MAX != m_nBestCost)
+            {
+                m_nBestCost = 0;
+                for (int k = 0; k + 1 < m_nCheckCount; k++)
+                {
+                    int nEdge = m_nHamilRect[m_nBestRoute[k]][m_nBestRoute[k + 1]];
+                    m_nBestCost = (INT_MAX == nEdge) ? INT_MAX : (m_nBestCost + nEdge);
+                    if (INT_MAX == m_nBestCost)
+                    {
+                        break;
+                    }
+                }
+            }
+            m_nBoundRoute[0] = 0;
+            lazySearch(0, 1, 0, 1);
+            if (INT_MAX == m_nBestCost)
+            {
+                pPath->nSteps = -1;
+                pPath->nCount = 0;
+                return m_bLazyNoMemory ? ORIENT_ERR_MEMORY : ORIENT_ERR_UNREACHABLE;
+            }
+            bool bExact = true;
+            for (int k = 0; k + 1 < m_nCheckCount; k++)
+            {
+                if (!m_bExact[m_nBestRoute[k]][m_nBestRoute[k + 1]])
+                {
+                    lazyDistance(m_nBestRoute[k], m_nBestRoute[k + 1]);
+                    bExact = false;
+                }
+            }
+            if (bExact)
+            {
+                break;
+            }
+        }
+        pPath->nSteps = m_nBestCost;
+        pPath->nCount = m_nCheckCount;
+        for (int k = 0; k < m_nCheckCount; k++)
+        {
+            pPath->nRoute[k] = m_nBestRoute[k];
+        }
+        return ORIENT_OK;
+    }
+    pPath->nSteps = hamiltonianPath(0, 1);
+    pPath->nCount = hamiltonianRoute(1, pPath->nRoute);
+    if (INT_MAX == pPath->nSteps)
+    {
+        pPath->nSteps = -1;
+        return ORIENT_ERR_UNREACHABLE;
+    }
+    return ORIENT_OK;
+}
+
+///////////////////////////////////////////////////////////////////
+// 函	数：solveAllGoals
+// 作	用：阶段2：一次DP得到从S出发、经过所有点、终止于每个点的最短路径
+// 参	数：OrientPath pPath[]	输出各终点的路径（至少pointCount()个元素）
+// 参	数：int* pnBest			输出步数最少的终点索引（“任意终点”的最优解）
+// 返	回：int		ORIENT_OK或错误码
+///////////////////////////////////////////////////////////////////
+int Orienteering::solveAllGoals(OrientPath pPath[], int* pnBest)
+{
+    int nCost[MAX_POINT];
+    int nStatus;
+    if ((2 > m_nPhase) || m_bLargeMap)
+    {
+        return ORIENT_ERR_STATE;
+    }
+    if (m_bLazyMatrix && (ORIENT_OK != (nStatus = completeMatrix())))
+    {
+        return nStatus;
+    }
+    if (0 != m_nDistStart)
+    {
+        hamiltonianSolve(0);
+    }
+    *pnBest = hamiltonianAllGoals(nCost);
+    for (int j = 0; j < m_nCheckCount; j++)
+    {
+        pPath[j].nSteps = (INT_MAX == nCost[j]) ? -1 : nCost[j];
+        pPath[j].nCount = hamiltonianRoute(j, pPath[j].nRoute);
+    }
+    return ORIENT_OK;
+}
+
+///////////////////////////////////////////////////////////////////
+// 函	数：solvePrize
+// 作	用：奖励收集模式：一次子集DP回答多个步数预算
+// 参	数：const int* pnBudget	步数预算数组
+// 参	数：int nCount			预算个数
+// 参	数：OrientPrize pPrize[]	输出各预算下的最优解
+// 返	回：int		ORIENT_OK或错误码
+///////////////////////////////////////////////////////////////////
+int Orienteering::solvePrize(const int* pnBudget, int nCount, OrientPrize pPrize[])
+{
+    int nBudgetMax = 0;
+    int nStatus;
+    if ((2 > m_nPhase) || m_bLargeMap)
+    {
+        return ORIENT_ERR_STATE;
+    }
+    if (m_bLazyMatrix && (ORIENT_OK != (nStatus = completeMatrix())))
+    {
+        return nStatus;
+    }
+    for (int b = 0; b < nCount; b++)
+    {
+        nBudgetMax = (pnBudget[b] > nBudgetMax) ? pnBudget[b] : nBudgetMax;
+    }
+    prizeSolve(nBudgetMax);
+    for (int b = 0; b < nCount; b++)
+    {
+        pPrize[b].nBudget = pnBudget[b];
+        pPrize[b].nScore = prizeQuery(pnBudget[b], pPrize[b].nRoute, &pPrize[b].nCount, &pPrize[b].nSteps);
+    }
+    // m_nDist已被改写，哈密顿模式需要重新运算
+    m_nDistStart = -1;
+    return ORIENT_OK;
+}
+
+///////////////////////////////////////////////////////////////////
+// 函	数：solvePrizeTour
+// 作	用：大点集的奖励收集模式：点数太多无法做子集DP，用贪心插入求
+//			一个预算下的较优解（非最优解）
+// 参	数：int nBudget		步数预算
+// 参	数：OrientTour* pTour	输出路径（pRoute由调用者提供）
+// 参	数：int* pnScore		输出收集的分值（预算内无法到达G为-1）
+// 返	回：int		ORIENT_OK或错误码
+///////////////////////////////////////////////////////////////////
+int Orienteering::solvePrizeTour(int nBudget, OrientTour* pTour, int* pnScore)
+{
+    if ((2 > m_nPhase) || !m_bLargeMap)
+    {
+        return ORIENT_ERR_STATE;
+    }
+    pTour->nSteps = -1;
+    pTour->nCount = 0;
+    *pnScore = -1;
+    if ((NULL == pTour->pRoute) || (pTour->nCapacity < m_nLargeCount))
+    {
+        return ORIENT_ERR_MEMORY;
+    }
+    *pnScore = prizeHeuristic(nBudget, pTour->pRoute, &pTour->nCount, &pTour->nSteps);
+    return ORIENT_OK;
+}
+
+///////////////////////////////////////////////////////////////////
+// 函	数：solveKBest
+// 作	用：阶段2：一次DP得到S经过所有'@'到达G的前nK条最短路径。
+//			DP表大小只取决于点数和nK，首次使用时按需申请（只增不减），
+//			占用的字节数可由kBestMemory查询
+// 参	数：int nK			路径条数（限制在1 ~ KBEST_MAX）
+// 参	数：OrientPath pPath[]	输出按步数递增的路径（至少nK个元素）
+// 参	数：int* pnCount		输出实际得到的路径条数（不同的访问顺序不足nK种时少于nK）
+// 返	回：int		ORIENT_OK或错误码
+///////////////////////////////////////////////////////////////////
+int Orienteering::solveKBest(int nK, OrientPath pPath[], int* pnCount)
+{
+    size_t nEntries;
+    int nStatus;
+    *pnCount = 0;
+    if ((2 > m_nPhase) || m_bLargeMap)
+    {
+        return ORIENT_ERR_STATE;
+    }
+    if (m_bLazyMatrix && (ORIENT_OK != (nStatus = completeMatrix())))
+    {
+        return nStatus;
+    }
+    nK = (1 > nK) ? 1 : ((KBEST_MAX < nK) ? KBEST_MAX : nK);
+    nEntries = ((size_t)1 << (m_nCheckCount - 1)) * m_nCheckCount * nK;
+    if (nEntries > m_nKBestCapacity)
+    {
+        free(m_pKBest);
+        m_pKBest = (MyKBestEntry*)malloc(nEntries * sizeof(MyKBestEntry));
+        m_nKBestCapacity = (NULL == m_pKBest) ? 0 : nEntries;
+        if (NULL == m_pKBest)
+        {
+            m_nKBestBytes = 0;
+            return ORIENT_ERR_MEMORY;
+        }
+    }
+    m_nKBestBytes = nEntries * sizeof(MyKBestEntry);
+    kBestSolve(nK);
+
+    // 全集、终止于G的状态中按步数递增的各条路径
+    const MyKBestEntry* pGoal = &m_pKBest[((size_t)(((1<<m_nCheckCount) - 1) >> 1) * m_nCheckCount + 1) * nK];
+    for (int r = 0; (r < nK) && (INT_MAX != pGoal[r].nCost); r++)
+    {
+        pPath[r].nSteps = pGoal[r].nCost;
+        pPath[r].nCount = kBestRoute(nK, r, pPath[r].nRoute);
+        (*pnCount)++;
+    }
+    return (0 == *pnCount) ? ORIENT_ERR_UNREACHABLE : ORIENT_OK;
+}
+
+///////////////////////////////////////////////////////////////////
+// 函	数：solveTour
+// 作	用：大点集模式：分簇求S经过所有'@'到达G的路径（近似解，点数
+//			不超过CLUSTER_MAX时为精确解）
+// 参	数：OrientTour* pTour	输出路径（pRoute由调用者提供）
+// 返	回：int		ORIENT_OK或错误码
+///////////////////////////////////////////////////////////////////
+int Orienteering::solveTour(OrientTour* pTour)
+{
+    if ((2 > m_nPhase) || !m_bLargeMap)
+    {
+        return ORIENT_ERR_STATE;
+    }
+    pTour->nSteps = -1;
+    pTour->nCount = 0;
+    if ((NULL == pTour->pRoute) || (pTour->nCapacity < m_nLargeCount))
+    {
+        return ORIENT_ERR_MEMORY;
+    }
+    int nCost = m_cluster.solve(m_pLargeDist, m_nLargeCount, m_nThreads, pTour->pRoute);
+    if (0 > nCost)
+    {
+        return ORIENT_ERR_MEMORY;
     }
+    pTour->nSteps = nCost;
+    pTour->nCount = m_nLargeCount;
+    return ORIENT_OK;
+}
+
+///////////////////////////////////////////////////////////////////
+// 函	数：parseNumber
+// 作	用：从文本中读取一个非负整数
+// 参	数：const char* p		读取位置
+// 参	数：const char* pEnd	文本结尾
+// 参	数：int* pnValue		输出读到的整数
+// 返	回：const char*	返回整数之后的位置，没有整数返回NULL
+///////////////////////////////////////////////////////////////////
+static const char* parseNumber(const char* p, const char* pEnd, int* pnValue)
+{
+    int nValue = 0;
+    if ((p >= pEnd) || ('0' > *p) || ('9' < *p))
+    {
+        return NULL;
+    }
+    for (; (p < pEnd) && ('0' <= *p) && ('9' >= *p); p++)
+    {
+        nValue = (nValue < 100000000) ? (nValue * 10 + (*p - '0')) : nValue;
+    }
+    *pnValue = nValue;
+    return p;
+}
+
+///////////////////////////////////////////////////////////////////
+// 函	数：nextLine
+// 作	用：跳到下一行行首
+// 参	数：const char* p		读取位置
+// 参	数：const char* pEnd	文本结尾
+// 返	回：const char*	返回下一行行首，没有下一行返回NULL
+///////////////////////////////////////////////////////////////////
+static const char* nextLine(const char* p, const char* pEnd)
+{
+    const char* pLine = (const char*)memchr(p, '\n', pEnd - p);
+    return (NULL == pLine) ? NULL : (pLine + 1);
+}
+
+///////////////////////////////////////////////////////////////////
+// 函	数：reserveChess
+// 作	用：预先申请nCells个格子的棋盘明细（已够用时不重新申请）
+// 参	数：int nCells		格子数
+// 返	回：bool		内存申请失败返回假
+///////////////////////////////////////////////////////////////////
+bool Orienteering::reserveChess(int nCells)
+{
+    if (nCells <= m_nChessCapacity)
+    {
+        return true;
+    }
+    free(m_pChess);
+    m_pChess = (char*)malloc(nCells);
+    m_nChessCapacity = (NULL == m_pChess) ? 0 : nCells;
+    return (NULL != m_pChess);
+}
+
+///////////////////////////////////////////////////////////////////
+// 函	数：reserveNodePool
+// 作	用：预先申请nCells个A*节点（已够用时不重新申请）
+// 参	数：int nCells		格子数
+// 返	回：bool		内存申请失败返回假
+///////////////////////////////////////////////////////////////////
+bool Orienteering::reserveNodePool(int nCells)
+{
+    if (nCells <= m_nNodeCapacity)
+    {
+        return true;
+    }
+    free(m_pNodePool);
+    m_pNodePool = (MyNode*)malloc((size_t)nCells * sizeof(MyNode));
+    m_nNodeCapacity = (NULL == m_pNodePool) ? 0 : nCells;
+    return (NULL != m_pNodePool);
+}
+
+///////////////////////////////////////////////////////////////////
+// 函	数：createChess
+// 作	用：由内存中的地图文本创建棋盘信息数组
+// 参	数：const char* pszText	地图文本
+// 参	数：const char* pszEnd	文本结尾
+// 返	回：int		ORIENT_OK或错误码
+///////////////////////////////////////////////////////////////////
+int Orienteering::createChess(const char* pszText, const char* pszEnd)
+{
+    const char* pLine = pszText;
+    const char* p;
     // 读取地图行列数
-    if (NULL == fgets(ln, MAX_WIDTH, fp))
+    p = parseNumber(pLine, pszEnd, &m_nWidth);
+    while ((NULL != p) && (p < pszEnd) && ((',' == *p) || (' ' == *p)))
     {
-        printf("Get width and height error.\n");
-        return false;
+        p++;
     }
-    if (-1 == sscanf(ln, "%d,%d", &m_nWidth, &m_nHeight))
+    if ((NULL == p) || (p == pLine) || (NULL == parseNumber(p, pszEnd, &m_nHeight)))
     {
-        printf("The width or height is error.%d,%s.\n", errno, strerror(errno));
-        return false;
+        return ORIENT_ERR_SIZE_LINE;
     }
     if ((1 > m_nWidth) || (MAX_WIDTH < m_nWidth))
     {
-        printf("width is error.(1 <= width <= 100)\n");
-        return false;
+        return ORIENT_ERR_WIDTH;
     }
     if ((1 > m_nHeight) || (MAX_HEIGHT < m_nHeight))
     {
-        printf("height is error.(1 <= height <= 100)\n");
-        return false;
+        return ORIENT_ERR_HEIGHT;
+    }
+    if (!reserveChess(m_nWidth * m_nHeight))
+    {
+        return ORIENT_ERR_MEMORY;
     }
     for (int i = 0; i < m_nHeight; i++)
     {
-        if (NULL == fgets(m_chess[i], MAX_WIDTH, fp))
+        char* pRow = m_pChess + (size_t)i * m_nWidth;
+        // 跳到下一行行首
+        pLine = nextLine(pLine, pszEnd);
+        if (NULL == pLine)
+        {
+            return ORIENT_ERR_MAP_DATA;
+        }
+        // 拷贝本行，不足宽度的部分以'\0'填充，由analyseChess判为非法字符
+        int j = 0;
+        for (; (j < m_nWidth) && (pLine + j < pszEnd) && ('\n' != pLine[j]) && ('\r' != pLine[j]) && ('\0' != pLine[j]); j++)
+        {
+            pRow[j] = pLine[j];
+        }
+        for (; j < m_nWidth; j++)
         {
-            printf("Get map data error.\n");
-            return false;
+            pRow[j] = '\0';
         }
     }
-    return true;
-//    scanf("%d %d\n", &m_nWidth, &m_nHeight);
-//    if ((1 > m_nWidth) || (100 < m_nWidth))
-//    {
-//        printf("width is error.(1 <= width <= 100)\n");
-//        return false;
-//    }
-//    if ((1 > m_nHeight) || (100 < m_nHeight))
-//    {
-//        printf("height is error.(1 <= height <= 100)\n");
-//        return false;
-//    }
-//    for (int i = 0; i < m_nHeight; i++)
-//    {
-//        gets(m_chess[i]);
-//    }
-//    return true;
+    // 地图之后可选的“x,y,分值”行，为对应的'@'指定奖励收集模式的分值
+    m_nScoreEntries = 0;
+    while ((NULL != (pLine = nextLine(pLine, pszEnd))) && (m_nScoreEntries < MAX_LARGE_POINT))
+    {
+        MyPoint* pPoint = &m_scorePoint[m_nScoreEntries];
+        p = parseNumber(pLine, pszEnd, &pPoint->x);
+        if ((NULL == p) || (p >= pszEnd) || (',' != *p))
+        {
+            continue;
+        }
+        p = parseNumber(p + 1, pszEnd, &pPoint->y);
+        if ((NULL == p) || (p >= pszEnd) || (',' != *p))
+        {
+            continue;
+        }
+        if (NULL != parseNumber(p + 1, pszEnd, &m_nScoreValue[m_nScoreEntries]))
+        {
+            m_nScoreEntries++;
+        }
+    }
+    return ORIENT_OK;
 }
 
 ///////////////////////////////////////////////////////////////////
 // 函	数：analyseChess
 // 作	用：分析棋盘
 // 参	数：void
-// 返	回：bool		分析输入数据的安全性，通过为真，否则为假
+// 返	回：int		分析输入数据的安全性，通过为ORIENT_OK，否则为错误码
 ///////////////////////////////////////////////////////////////////
-bool Orienteering::analyseChess()
+int Orienteering::analyseChess()
 {
     int nMaxCheck = MAX_CHECK;
     bool bStart = false;
     bool bGoal = false;
 
     m_nCheckCount = 2;
+    m_nLargeCount = 2;
+    m_bLargeMap = m_bLarge;
+    m_bWeighted = false;
+    if (!m_grid.create(m_nWidth, m_nHeight, m_nLayout))
+    {
+        return ORIENT_ERR_MEMORY;
+    }
 
     for (int i = 0; i < m_nHeight; i++)
     {
+        const char* pRow = m_pChess + (size_t)i * m_nWidth;
         for (int j = 0; j < m_nWidth; j++)
         {
-            if ('S' == m_chess[i][j])
+            int nCost = 1;
+            if ('S' == pRow[j])
             {
                 if (!bStart)
                 {
@@ -255,11 +607,10 @@ bool Orienteering::analyseChess()
                 }
                 else
                 {
-                    printf("'S' has exceeded the maximum limit.(max:1)\n");
-                    return false;
+                    return ORIENT_ERR_MULTI_START;
                 }
             }
-            else if ('G' == m_chess[i][j])
+            else if ('G' == pRow[j])
             {
                 if (!bGoal)
                 {
@@ -269,14 +620,24 @@ bool Orienteering::analyseChess()
                 }
                 else
                 {
-                    printf("'G' has exceeded the maximum limit.(max:1)\n");
-                    return false;
+                    return ORIENT_ERR_MULTI_GOAL;
                 }
 
             }
-            else if ('@' == m_chess[i][j])
+            else if ('@' == pRow[j])
             {
-                if (m_nCheckCount < nMaxCheck)
+                if (m_bLargeMap)
+                {
+                    // 大点集模式：'@'放入单独的节点数组
+                    if (MAX_LARGE_POINT <= m_nLargeCount)
+                    {
+                        return ORIENT_ERR_MULTI_CHECK;
+                    }
+                    m_largePoint[m_nLargeCount].x = j;
+                    m_largePoint[m_nLargeCount].y = i;
+                    m_nLargeCount++;
+                }
+                else if (m_nCheckCount < nMaxCheck)
                 {
                     m_point[m_nCheckCount].x = j;
                     m_point[m_nCheckCount].y = i;
@@ -284,32 +645,67 @@ bool Orienteering::analyseChess()
                 }
                 else
                 {
-                    printf("'@' has exceeded the maximum limit.(max:%d)\n", MAX_CHECK);
-                    return false;
+                    return ORIENT_ERR_MULTI_CHECK;
+                }
+            }
+            else if (('1' <= pRow[j]) && ('9' >= pRow[j]))
+            {
+                // 慢行区域，记录进入该格子的代价
+                nCost = pRow[j] - '0';
+                if (1 < nCost)
+                {
+                    m_bWeighted = true;
                 }
             }
             else
             {
-                if (!(('.' == m_chess[i][j]) || ('#' == m_chess[i][j])))
+                if (!(('.' == pRow[j]) || ('#' == pRow[j])))
                 {
                     // 如果遇到非以上字符，则返回错误
-                    printf("The discovery of illegal characters.\n");
-                    return false;
+                    return ORIENT_ERR_ILLEGAL_CHAR;
+                }
+                if ('#' == pRow[j])
+                {
+                    nCost = 0;
                 }
             }
+            m_grid.setCost(j, i, nCost);
         }
     }
     if (!bStart)
     {
-        printf("Did not find 'S'.\n");
-        return false;
+        return ORIENT_ERR_NO_START;
     }
     if (!bGoal)
     {
-        printf("Did not find 'G'.\n");
-        return false;
+        return ORIENT_ERR_NO_GOAL;
     }
-    return true;
+    m_largePoint[0] = m_point[0];
+    m_largePoint[1] = m_point[1];
+    // 奖励收集模式的分值
+    for (int k = 0; m_bLargeMap && (k < m_nLargeCount); k++)
+    {
+        m_nLargeScore[k] = (2 > k) ? 0 : 1;
+        for (int e = 0; (2 <= k) && (e < m_nScoreEntries); e++)
+        {
+            if ((m_scorePoint[e].x == m_largePoint[k].x) && (m_scorePoint[e].y == m_largePoint[k].y))
+            {
+                m_nLargeScore[k] = m_nScoreValue[e];
+            }
+        }
+    }
+    for (int k = 0; k < m_nCheckCount; k++)
+    {
+        m_nScore[k] = (2 > k) ? 0 : 1;
+        for (int e = 0; e < m_nScoreEntries; e++)
+        {
+            if ((2 <= k) && (m_scorePoint[e].x == m_point[k].x) && (m_scorePoint[e].y == m_point[k].y))
+            {
+                m_nScore[k] = m_nScoreValue[e];
+            }
+        }
+    }
+    return ORIENT_OK;
 }
 
 ///////////////////////////////////////////////////////////////////
@@ -321,8 +717,7 @@ bool Orienteering::analyseChess()
 ///////////////////////////////////////////////////////////////////
 int Orienteering::gethAstar(MyPoint pointN, MyPoint pointG)
 {
-    // 尚未进行开方运算
-    return ((pointG.x - pointN.x) * (pointG.x - pointN.x) + (pointG.y - pointN.y) * (pointG.y - pointN.y));
+    return m_heuristic.estimate(pointN.x, pointN.y, pointG.x, pointG.y);
 }
 
 ///////////////////////////////////////////////////////////////////
@@ -384,7 +779,6 @@ void Orienteering::moveOPENtoCLOSED(MyPoint point)
     }
     if (!pOpen)
     {
-        printf("error！在listOPEN中未找到符合要求的节点！");
         return;
     }
     // 把该节点从listOPEN表中取出
@@ -437,7 +831,6 @@ void Orienteering::moveCLOSEDtoOPEN(MyPoint point)
     }
     if (!pClosed)
     {
-        printf("error！在listCLOSED中未找到符合要求的节点！");
         return;
     }
     // 把该节点从listCLOSED表中取出
@@ -475,7 +868,7 @@ void Orienteering::moveCLOSEDtoOPEN(MyPoint point)
 ///////////////////////////////////////////////////////////////////
 bool Orienteering::isSureNode(MyPoint point)
 {
-    return ('#' != m_chess[point.y][point.x]);
+    return m_grid.isSure(m_grid.cell(point.x, point.y));
 }
 
 ///////////////////////////////////////////////////////////////////
@@ -565,50 +958,48 @@ void Orienteering::generateList(MyNode* pParentNode, MyPoint pointChild, MyPoint
     MyNode* pResultOPEN;
     MyNode* pResultCLOSED;
     MyNode* pNode;
-    // 新开辟个节点空间
-    pNode = (MyNode*)calloc(1, sizeof(MyNode));
-    pNode->point.x = pointChild.x;
-    pNode->point.y = pointChild.y;
-    pNode->gAstar = pParentNode->gAstar + 1;
-    pNode->hAstar = gethAstar(pointChild, pointGoal);
-    pNode->fAstar = pNode->gAstar + pNode->hAstar;
-    //pNode->pNext = NULL; // 尚未定论
-    pNode->pParent = pParentNode;
+    int gAstar = pParentNode->gAstar + m_grid.cost(m_grid.cell(pointChild.x, pointChild.y));
+    int hAstar = gethAstar(pointChild, pointGoal);
+    int fAstar = gAstar + hAstar;
     // 对该节点进行判断处理
     pResultOPEN = isNodeInlistOPEN(pointChild);
     pResultCLOSED = isNodeInlistCLOSED(pointChild);
 
     if (pResultOPEN)
     {
-        if (pNode->fAstar < pResultOPEN->fAstar)
+        if (fAstar < pResultOPEN->fAstar)
         {
             // 1、该节点在OPEN里，f(s)比原值小,那么就替换原先节点，做好父节点指针。
-            pResultOPEN->gAstar = pNode->gAstar;
-            pResultOPEN->hAstar = pNode->hAstar;
-            pResultOPEN->fAstar = pNode->fAstar;
-            pResultOPEN->pParent = pNode->pParent;
-            // 释放空间
-            free(pNode);
+            pResultOPEN->gAstar = gAstar;
+            pResultOPEN->hAstar = hAstar;
+            pResultOPEN->fAstar = fAstar;
+            pResultOPEN->pParent = pParentNode;
         }
 
     }
     else if (pResultCLOSED)
     {
-        if (pNode->fAstar < pResultCLOSED->fAstar)
+        if (fAstar < pResultCLOSED->fAstar)
         {
             // 2、该节点在CLOSE里，f(s)比原值小，将CLOSE放入OPEN中，做好父节点指针。
-            pResultCLOSED->gAstar = pNode->gAstar;
-            pResultCLOSED->hAstar = pNode->hAstar;
-            pResultCLOSED->fAstar = pNode->fAstar;
-            pResultCLOSED->pParent = pNode->pParent;
+            pResultCLOSED->gAstar = gAstar;
+            pResultCLOSED->hAstar = hAstar;
+            pResultCLOSED->fAstar = fAstar;
+            pResultCLOSED->pParent = pParentNode;
             moveCLOSEDtoOPEN(pointChild);   // 算法重复有空改一下
-            // 释放空间
-            free(pNode);
         }
     }
     else
     {
-        // 3、该节点不在OPEN、CLOSED里，那么就加到OPEN表中，做好父节点指针。
+        // 3、该节点不在OPEN、CLOSED里，那么就从节点池取一个节点加到OPEN表中，做好父节点指针。
+        // 每个格子最多进入一次，节点池大小为格子数即可
+        pNode = &m_pNodePool[m_nNodeCount++];
+        pNode->point.x = pointChild.x;
+        pNode->point.y = pointChild.y;
+        pNode->gAstar = gAstar;
+        pNode->hAstar = hAstar;
+        pNode->fAstar = fAstar;
+        pNode->pParent = pParentNode;
         inserttolistOPEN(pNode);
     }
 
@@ -623,42 +1014,15 @@ void Orienteering::generateList(MyNode* pParentNode, MyPoint pointChild, MyPoint
 ///////////////////////////////////////////////////////////////////
 void Orienteering::createChildNodeIntoOpen(MyNode *pParentNode, MyPoint pointGoal)
 {
+    // 四个方向的偏移量：上、下、左、右
+    const int nDirX[4] = { 0, 0, -1, 1 };
+    const int nDirY[4] = { -1, 1, 0, 0 };
     MyPoint pointChild;
-    // 上
-    pointChild.x = pParentNode->point.x;
-    pointChild.y = pParentNode->point.y - 1;
-    if ( pointChild.y >= 0 )
-    {
-        if ( isSureNode( pointChild ) )
-        {
-            generateList(pParentNode, pointChild, pointGoal);
-        }
-    }
-    // 下
-    pointChild.x = pParentNode->point.x;
-    pointChild.y = pParentNode->point.y + 1;
-    if ( pointChild.y < m_nHeight )
-    {
-        if ( isSureNode( pointChild ) )
-        {
-            generateList(pParentNode, pointChild, pointGoal);
-        }
-    }
-    // 左
-    pointChild.x = pParentNode->point.x - 1;
-    pointChild.y = pParentNode->point.y;
-    if ( pointChild.x >= 0 )
-    {
-        if ( isSureNode( pointChild ) )
-        {
-            generateList(pParentNode, pointChild, pointGoal);
-        }
-    }
-    // 右
-    pointChild.x = pParentNode->point.x + 1;
-    pointChild.y = pParentNode->point.y;
-    if ( pointChild.y < m_nWidth )
+    // 棋盘四周有哨兵墙，子节点坐标最多越出地图一格，无需判断边界
+    for (int d = 0; d < 4; d++)
     {
+        pointChild.x = pParentNode->point.x + nDirX[d];
+        pointChild.y = pParentNode->point.y + nDirY[d];
         if ( isSureNode( pointChild ) )
         {
             generateList(pParentNode, pointChild, pointGoal);
@@ -667,32 +1031,12 @@ void Orienteering::createChildNodeIntoOpen(MyNode *pParentNode, MyPoint pointGoa
     return;
 }
 
-///////////////////////////////////////////////////////////////////
-// 函	数：DestroyList
-// 作	用：销毁表指定表
-// 参	数：MyNode *pHead		需要销毁的链表头指针
-// 返	回：void
-///////////////////////////////////////////////////////////////////
-void Orienteering::DestroyList(MyNode *pHead)
-{
-    if (NULL != pHead)
-    {
-        MyNode *p;
-        while (pHead)
-        {
-            p = pHead->pNext;
-            free(pHead);
-            pHead = p;
-        }
-    }
-}
-
 ///////////////////////////////////////////////////////////////////
 // 函	数：AstarMain
 // 作	用：A*算法主要流程
 // 参	数：MyPoint pointGoal		起点信息（A*算法结果是逆向输出）
 // 参	数：MyPoint pointStart		终点信息
-// 返	回：void
+// 返	回：int		返回两点之间的最短代价，不通返回-1
 ///////////////////////////////////////////////////////////////////
 int Orienteering::AstarMain(MyPoint pointGoal, MyPoint pointStart)
 {
@@ -703,10 +1047,10 @@ int Orienteering::AstarMain(MyPoint pointGoal, MyPoint pointStart)
     listCLOSED = NULL;
     // 路径相关
     int nPathCount = -1;
-    MyNode* pPath = NULL;
 
-    // 生成起始节点
-    pNode = (MyNode*)calloc( 1, sizeof( MyNode ) );
+    // 生成起始节点（节点池每次搜索从头使用）
+    m_nNodeCount = 0;
+    pNode = &m_pNodePool[m_nNodeCount++];
     // 录入起始点坐标等属性信息
     pNode->point.x = pointStart.x;
     pNode->point.y = pointStart.y;
@@ -736,6 +1080,7 @@ int Orienteering::AstarMain(MyPoint pointGoal, MyPoint pointStart)
             {
                 // 如果该节点不是目标节点就使其生成子节点，添加到listOPEN表中
                 createChildNodeIntoOpen(pNodeBest, pointGoal);
+                m_nExpandCount++;
             }
         }
         else
@@ -746,20 +1091,15 @@ int Orienteering::AstarMain(MyPoint pointGoal, MyPoint pointStart)
 
     }
     //////////////////////////////////////////////////////////////////////////
-    // 得到路径
-    pPath = pNodeBest;
-
-    while (pPath)
+    // 得到路径代价（带权地形下不再等于路径上的节点数）
+    if (pNodeBest)
     {
-        //printf("(%d, %d)=>", pPath->point.x, pPath->point.y);
-        pPath = pPath->pParent;
-        nPathCount++;
+        nPathCount = pNodeBest->gAstar;
     }
-    //printf("\nResult moves %d times.\n", nPathCount);
 
-    // 释放OPEN和CLOSED表内存
-    DestroyList(listOPEN);
-    DestroyList(listCLOSED);
+    // 节点都在节点池中，清空表即可
+    listOPEN = NULL;
+    listCLOSED = NULL;
 
     return nPathCount;
 
@@ -769,12 +1109,46 @@ int Orienteering::AstarMain(MyPoint pointGoal, MyPoint pointStart)
 // 函	数：createHamilRect
 // 作	用：生成距离矩阵
 // 参	数：void
-// 返	回：bool		如果有任意两点不通返回假，任意两点都通都通返回真
+// 返	回：int		任意两点都通返回ORIENT_OK，有任意两点不通返回ORIENT_ERR_UNREACHABLE
 ///////////////////////////////////////////////////////////////////
-bool Orienteering::createHamilRect()
+int Orienteering::createHamilRect()
 {
     int nPath;
 
+    m_nExpandCount = 0;
+    if (ENGINE_GRAPH == m_nEngine)
+    {
+        return createHamilRectGraph();
+    }
+    if (m_bWeighted || (ENGINE_BFS == m_nEngine))
+    {
+        // 带权地形：每个点做一次Dial单源搜索，一次得到该点到所有点的代价
+        // （'S'、'G'、'@'的进入代价都为1，因此矩阵仍然对称）；
+        // ENGINE_BFS的无权地图：每个点做一次多线程广度优先搜索
+        for (int i = 0; i < m_nCheckCount; i++)
+        {
+            int nSource = m_grid.cell(m_point[i].x, m_point[i].y);
+            if (!(m_bWeighted ? m_dial.run(m_grid, nSource) : m_bfs.run(m_grid, nSource)))
+            {
+                return ORIENT_ERR_MEMORY;
+            }
+            for (int j = 0; j < m_nCheckCount; j++)
+            {
+                int nCell = m_grid.cell(m_point[j].x, m_point[j].y);
+                nPath = m_bWeighted ? m_dial.distance(nCell) : m_bfs.distance(nCell);
+                // 如果发现不通路，直接返回错误
+                if (INT_MAX == nPath)
+                {
+                    return ORIENT_ERR_UNREACHABLE;
+                }
+                m_nHamilRect[i][j] = nPath;
+            }
+        }
+        return ORIENT_OK;
+    }
+
+    // 准备A*估价，地标代价场所有点对共享
+    m_heuristic.prepare(m_grid, m_grid.cell(m_point[0].x, m_point[0].y), m_nHeuristic, m_dial);
     for (int i = 0; i < m_nCheckCount; i++)
     {
         for (int j = i; j < m_nCheckCount; j++)
@@ -786,19 +1160,387 @@ bool Orienteering::createHamilRect()
             else
             {
                 nPath = AstarMain(m_point[i], m_point[j]);
-                // 如果发现不通路，直接返回为假
+                // 如果发现不通路，直接返回错误
                 if (-1 == nPath)
                 {
-                    return false;
+                    return ORIENT_ERR_UNREACHABLE;
                 }
                 m_nHamilRect[i][j] = nPath;
                 m_nHamilRect[j][i] = nPath;
             }
         }
     }
+    return ORIENT_OK;
+}
+
+///////////////////////////////////////////////////////////////////
+// 函	数：createHamilRectGraph
+// 作	用：在通道收缩图上生成距离矩阵。剪掉死胡同、收缩通道后图规模
+//			远小于格子数，每个点做一次图上的Dijkstra即得到一整行
+//			（边权为沿通道进入各格子的代价之和，无权、带权地图都适用）
+// 参	数：void
+// 返	回：int		任意两点都通返回ORIENT_OK，否则为错误码
+///////////////////////////////////////////////////////////////////
+int Orienteering::createHamilRectGraph()
+{
+    int nPointCell[MAX_POINT];
+    int nPath;
+
+    for (int i = 0; i < m_nCheckCount; i++)
+    {
+        nPointCell[i] = m_grid.cell(m_point[i].x, m_point[i].y);
+    }
+    if (!m_graph.build(m_grid, nPointCell, m_nCheckCount))
+    {
+        return ORIENT_ERR_MEMORY;
+    }
+    for (int i = 0; i < m_nCheckCount; i++)
+    {
+        m_graph.run(m_graph.nodeOfCell(nPointCell[i]));
+        for (int j = 0; j < m_nCheckCount; j++)
+        {
+            nPath = m_graph.distance(m_graph.nodeOfCell(nPointCell[j]));
+            // 如果发现不通路，直接返回错误
+            if (INT_MAX == nPath)
+            {
+                return ORIENT_ERR_UNREACHABLE;
+            }
+            m_nHamilRect[i][j] = nPath;
+        }
+    }
+    return ORIENT_OK;
+}
+
+///////////////////////////////////////////////////////////////////
+// 函	数：searchRow
+// 作	用：用单源引擎计算一点到各点的距离：ENGINE_GRAPH用收缩图（须已
+//			以pnCell建好），带权地图用Dial，其余用多线程BFS
+// 参	数：int nSource		源点在pnCell中的位置
+// 参	数：const int* pnCell	各点的格子下标
+// 参	数：int nCount		点数
+// 参	数：int* pnRow		输出源点到各点的距离（不通为INT_MAX）
+// 返	回：bool		内存申请失败返回假
+///////////////////////////////////////////////////////////////////
+bool Orienteering::searchRow(int nSource, const int* pnCell, int nCount, int* pnRow)
+{
+    if (ENGINE_GRAPH == m_nEngine)
+    {
+        m_graph.run(m_graph.nodeOfCell(pnCell[nSource]));
+        for (int k = 0; k < nCount; k++)
+        {
+            pnRow[k] = m_graph.distance(m_graph.nodeOfCell(pnCell[k]));
+        }
+        return true;
+    }
+    if (!(m_bWeighted ? m_dial.run(m_grid, pnCell[nSource]) : m_bfs.run(m_grid, pnCell[nSource])))
+    {
+        return false;
+    }
+    for (int k = 0; k < nCount; k++)
+    {
+        pnRow[k] = m_bWeighted ? m_dial.distance(pnCell[k]) : m_bfs.distance(pnCell[k]);
+    }
     return true;
 }
 
+///////////////////////////////////////////////////////////////////
+// 函	数：createLargeRect
+// 作	用：生成大点集距离矩阵。点对数量很多，逐对A*不可行，每个点做
+//			一次单源搜索得到一整行
+// 参	数：void
+// 返	回：int		任意两点都通返回ORIENT_OK，否则为错误码
+///////////////////////////////////////////////////////////////////
+int Orienteering::createLargeRect()
+{
+    int nCell[MAX_LARGE_POINT];
+    int n = m_nLargeCount;
+
+    if (n * n > m_nLargeCapacity)
+    {
+        free(m_pLargeDist);
+        m_pLargeDist = (int*)malloc(n * n * sizeof(int));
+        m_nLargeCapacity = (NULL == m_pLargeDist) ? 0 : (n * n);
+        if (NULL == m_pLargeDist)
+        {
+            return ORIENT_ERR_MEMORY;
+        }
+    }
+    for (int k = 0; k < n; k++)
+    {
+        nCell[k] = m_grid.cell(m_largePoint[k].x, m_largePoint[k].y);
+    }
+    if ((ENGINE_GRAPH == m_nEngine) && !m_graph.build(m_grid, nCell, n))
+    {
+        return ORIENT_ERR_MEMORY;
+    }
+    for (int i = 0; i < n; i++)
+    {
+        int* pRow = m_pLargeDist + i * n;
+        if (!searchRow(i, nCell, n, pRow))
+        {
+            return ORIENT_ERR_MEMORY;
+        }
+        for (int k = 0; k < n; k++)
+        {
+            // 如果发现不通路，直接返回错误
+            if (INT_MAX == pRow[k])
+            {
+                return ORIENT_ERR_UNREACHABLE;
+            }
+        }
+    }
+    // S、G之间的距离同时放入普通矩阵，供distance查询
+    for (int i = 0; i < 2; i++)
+    {
+        for (int j = 0; j < 2; j++)
+        {
+            m_nHamilRect[i][j] = m_pLargeDist[i * n + j];
+            m_bExact[i][j] = true;
+        }
+    }
+    return ORIENT_OK;
+}
+
+///////////////////////////////////////////////////////////////////
+// 函	数：createLazyRect
+// 作	用：生成下界矩阵。每步进入格子的代价至少为1，曼哈顿距离即为
+//			任意地图上的下界；精确距离等到分支定界需要时再搜索
+// 参	数：void
+// 返	回：void
+///////////////////////////////////////////////////////////////////
+void Orienteering::createLazyRect()
+{
+    m_nExpandCount = 0;
+    m_nExactSearches = 0;
+    m_nBoundNodes = 0;
+    m_bLazyPrepared = false;
+    m_bLazyNoMemory = false;
+    for (int i = 0; i < m_nCheckCount; i++)
+    {
+        for (int j = 0; j < m_nCheckCount; j++)
+        {
+            m_nHamilRect[i][j] = abs(m_point[i].x - m_point[j].x) + abs(m_point[i].y - m_point[j].y);
+            m_bExact[i][j] = (i == j);
+        }
+    }
+}
+
+///////////////////////////////////////////////////////////////////
+// 函	数：lazyDistance
+// 作	用：取得i、j两点的精确距离，未计算时运行一次搜索并缓存。
+//			ENGINE_GRID的无权地图只搜索该点对（A*）；单源引擎（Dial、
+//			多线程BFS、收缩图）一次搜索即得到i到所有点的整行
+// 参	数：int i		点索引
+// 参	数：int j		点索引
+// 返	回：int		精确距离，不通返回INT_MAX
+///////////////////////////////////////////////////////////////////
+int Orienteering::lazyDistance(int i, int j)
+{
+    int nPointCell[MAX_POINT];
+    int nRow[MAX_POINT];
+    int nPath;
+
+    if (m_bExact[i][j])
+    {
+        return m_nHamilRect[i][j];
+    }
+    m_nExactSearches++;
+    if ((ENGINE_GRID == m_nEngine) && !m_bWeighted)
+    {
+        if (!m_bLazyPrepared)
+        {
+            m_heuristic.prepare(m_grid, m_grid.cell(m_point[0].x, m_point[0].y), m_nHeuristic, m_dial);
+            m_bLazyPrepared = true;
+        }
+        nPath = AstarMain(m_point[i], m_point[j]);
+        nPath = (-1 == nPath) ? INT_MAX : nPath;
+        m_nHamilRect[i][j] = nPath;
+        m_nHamilRect[j][i] = nPath;
+        m_bExact[i][j] = true;
+        m_bExact[j][i] = true;
+        return nPath;
+    }
+
+    for (int k = 0; k < m_nCheckCount; k++)
+    {
+        nPointCell[k] = m_grid.cell(m_point[k].x, m_point[k].y);
+    }
+    if ((ENGINE_GRAPH == m_nEngine) && !m_bLazyPrepared)
+    {
+        m_bLazyPrepared = m_graph.build(m_grid, nPointCell, m_nCheckCount);
+    }
+    // 内存不足时按不通处理，并记下原因，求解函数据此返回ORIENT_ERR_MEMORY
+    bool bOk = ((ENGINE_GRAPH != m_nEngine) || m_bLazyPrepared) && searchRow(i, nPointCell, m_nCheckCount, nRow);
+    m_bLazyNoMemory = m_bLazyNoMemory || !bOk;
+    for (int k = 0; k < m_nCheckCount; k++)
+    {
+        nPath = bOk ? nRow[k] : INT_MAX;
+        m_nHamilRect[i][k] = nPath;
+        m_nHamilRect[k][i] = nPath;
+        m_bExact[i][k] = true;
+        m_bExact[k][i] = true;
+    }
+    return m_nHamilRect[i][j];
+}
+
+///////////////////////////////////////////////////////////////////
+// 函	数：completeMatrix
+// 作	用：补全所有点对的精确距离，之后DP类求解函数可直接使用矩阵
+// 参	数：void
+// 返	回：int		任意两点都通返回ORIENT_OK，否则为ORIENT_ERR_UNREACHABLE
+//					（搜索时内存不足为ORIENT_ERR_MEMORY）
+///////////////////////////////////////////////////////////////////
+int Orienteering::completeMatrix()
+{
+    for (int i = 0; i < m_nCheckCount; i++)
+    {
+        for (int j = i + 1; j < m_nCheckCount; j++)
+        {
+            if (!m_bExact[i][j])
+            {
+                // 矩阵有变化，已有的DP表失效
+                m_nDistStart = -1;
+            }
+            if (INT_MAX == lazyDistance(i, j))
+            {
+                return m_bLazyNoMemory ? ORIENT_ERR_MEMORY : ORIENT_ERR_UNREACHABLE;
+            }
+        }
+    }
+    return ORIENT_OK;
+}
+
+///////////////////////////////////////////////////////////////////
+// 函	数：lazyBound
+// 作	用：从nLast出发经过所有未访问的'@'到达G的剩余步数下界。
+//			未访问的'@'和G各需一条入边，nLast和未访问的'@'各需一条出边，
+//			分别取每个点最短的入边、出边求和，取两者较大值。矩阵中已精确
+//			的点对用精确距离，其余用下界
+// 参	数：int nLast		当前所在节点
+// 参	数：int nMask		已访问的节点子集（含nLast）
+// 返	回：int		剩余步数下界，无法到达G返回INT_MAX
+///////////////////////////////////////////////////////////////////
+int Orienteering::lazyBound(int nLast, int nMask)
+{
+    int nOpen = ((1<<m_nCheckCount) - 1) & ~nMask & ~2;
+    long long llIn = 0;
+    long long llOut = 0;
+
+    for (int r = 1; r < m_nCheckCount; r++)
+    {
+        if ((1 != r) && !(nOpen & (1<<r)))
+        {
+            continue;
+        }
+        int nMin = m_nHamilRect[nLast][r];
+        for (int u = 2; u < m_nCheckCount; u++)
+        {
+            if ((u != r) && (nOpen & (1<<u)) && (m_nHamilRect[u][r] < nMin))
+            {
+                nMin = m_nHamilRect[u][r];
+            }
+        }
+        if (INT_MAX == nMin)
+        {
+            return INT_MAX;
+        }
+        llIn += nMin;
+    }
+    for (int u = 0; u < m_nCheckCount; u++)
+    {
+        if ((nLast != u) && !(nOpen & (1<<u)))
+        {
+            continue;
+        }
+        int nMin = m_nHamilRect[u][1];
+        for (int r = 2; r < m_nCheckCount; r++)
+        {
+            if ((u != r) && (nOpen & (1<<r)) && (m_nHamilRect[u][r] < nMin))
+            {
+                nMin = m_nHamilRect[u][r];
+            }
+        }
+        if (INT_MAX == nMin)
+        {
+            return INT_MAX;
+        }
+        llOut += nMin;
+    }
+    long long llBound = (llIn > llOut) ? llIn : llOut;
+    return (INT_MAX <= llBound) ? INT_MAX : (int)llBound;
+}
+
+///////////////////////////////////////////////////////////////////
+// 函	数：lazySearch
+// 作	用：在当前矩阵上分支定界深度优先搜索（不做精确搜索）。子节点按
+//			“已走步数 + 边长 + 剩余下界”排序，估计值不小于当前最优解的
+//			子节点直接剪掉
+// 参	数：int nLast		当前所在节点
+// 参	数：int nMask		已访问的节点子集（含nLast）
+// 参	数：int nCost		已走步数（按当前矩阵）
+// 参	数：int nDepth		m_nBoundRoute中已有的节点数
+// 返	回：void
+///////////////////////////////////////////////////////////////////
+void Orienteering::lazySearch(int nLast, int nMask, int nCost, int nDepth)
+{
+    int nOpen = ((1<<m_nCheckCount) - 1) & ~nMask & ~2;
+    int nChild[MAX_POINT];
+    int nEstimate[MAX_POINT];
+    int nCount = 0;
+
+    m_nBoundNodes++;
+    if (0 == nOpen)
+    {
+        // 所有'@'都已访问，最后一段到G
+        int nEdge = m_nHamilRect[nLast][1];
+        if ((INT_MAX != nEdge) && (nCost + nEdge < m_nBestCost))
+        {
+            m_nBestCost = nCost + nEdge;
+            for (int k = 0; k < nDepth; k++)
+            {
+                m_nBestRoute[k] = m_nBoundRoute[k];
+            }
+            m_nBestRoute[nDepth] = 1;
+        }
+        return;
+    }
+
+    // 按估计值插入排序
+    for (int k = 2; k < m_nCheckCount; k++)
+    {
+        if (!(nOpen & (1<<k)) || (INT_MAX == m_nHamilRect[nLast][k]))
+        {
+            continue;
+        }
+        int nRest = lazyBound(k, nMask | (1<<k));
+        if (INT_MAX == nRest)
+        {
+            continue;
+        }
+        int nValue = nCost + m_nHamilRect[nLast][k] + nRest;
+        int c = nCount++;
+        while ((0 < c) && (nEstimate[c - 1] > nValue))
+        {
+            nEstimate[c] = nEstimate[c - 1];
+            nChild[c] = nChild[c - 1];
+            c--;
+        }
+        nEstimate[c] = nValue;
+        nChild[c] = k;
+    }
+
+    for (int c = 0; c < nCount; c++)
+    {
+        if (nEstimate[c] >= m_nBestCost)
+        {
+            break;
+        }
+        int k = nChild[c];
+        m_nBoundRoute[nDepth] = k;
+        lazySearch(k, nMask | (1<<k), nCost + m_nHamilRect[nLast][k], nDepth + 1);
+    }
+}
+
 ///////////////////////////////////////////////////////////////////
 // 函	数：hamiltonianFloyd
 // 作	用：运算哈密顿floyd
@@ -823,15 +1565,15 @@ void Orienteering::hamiltonianFloyd()
 }
 
 ///////////////////////////////////////////////////////////////////
-// 函	数：hamiltonianPath
-// 作	用：求哈密顿最短路径
+// 函	数：hamiltonianSolve
+// 作	用：以指定起点运算一次哈密顿DP表。m_nDist[全集][j]即为经过所有
+//			节点且终止于j的最短步数，因此一次运算可回答所有终点的查询
 // 参	数：int nIndexS		起点的数组索引值
-// 参	数：int nIndexG		终点的数组索引值
-// 返	回：int		返回设置起始两点，且经过所有节点最短路径的步数
+// 返	回：void
 ///////////////////////////////////////////////////////////////////
-int Orienteering::hamiltonianPath(int nIndexS, int nIndexG)
+void Orienteering::hamiltonianSolve(int nIndexS)
 {
-    int pow2[MAX_POINT];
+    int pow2[MAX_POINT + 1];
     for(int o = 0; o <= m_nCheckCount; o++)
     {
         pow2[o] = (1<<o);
@@ -865,63 +1607,475 @@ int Orienteering::hamiltonianPath(int nIndexS, int nIndexG)
             }
         }
     }
-    return m_nDist[pow2[m_nCheckCount]-1][nIndexG];
+    m_nDistStart = nIndexS;
 }
 
 ///////////////////////////////////////////////////////////////////
-// 函	数：main
-// 作	用：Orienteering类的入口主函数
-// 参	数：void
+// 函	数：hamiltonianCost
+// 作	用：从DP表中查询经过所有节点、终止于指定终点的最短步数
+// 参	数：int nIndexG		终点的数组索引值
+// 返	回：int		返回最短步数，无解返回INT_MAX
+///////////////////////////////////////////////////////////////////
+int Orienteering::hamiltonianCost(int nIndexG)
+{
+    return m_nDist[(1<<m_nCheckCount)-1][nIndexG];
+}
+
+///////////////////////////////////////////////////////////////////
+// 函	数：hamiltonianAllGoals
+// 作	用：从DP表中查询所有终点的最短步数
+// 参	数：int nCost[]		输出各终点的最短步数（至少m_nCheckCount个元素）
+// 返	回：int		返回步数最少的终点索引（“任意终点”的最优解）
+///////////////////////////////////////////////////////////////////
+int Orienteering::hamiltonianAllGoals(int nCost[])
+{
+    int nBest = m_nDistStart;
+    for (int j = 0; j < m_nCheckCount; j++)
+    {
+        nCost[j] = hamiltonianCost(j);
+        if (nCost[j] < nCost[nBest])
+        {
+            nBest = j;
+        }
+    }
+    return nBest;
+}
+
+///////////////////////////////////////////////////////////////////
+// 函	数：backtrackRoute
+// 作	用：从DP表中回溯经过指定子集、终止于指定终点的最短路径
+// 参	数：int nMask		经过的节点子集（须包含起点和终点）
+// 参	数：int nIndexG		终点的数组索引值
+// 参	数：bool bGoalLast	G（索引1）是否只能作为最后一个节点
+// 参	数：int nRoute[]	输出节点索引序列（至少m_nCheckCount个元素）
+// 返	回：int		返回序列长度，无解返回0
+///////////////////////////////////////////////////////////////////
+int Orienteering::backtrackRoute(int nMask, int nIndexG, bool bGoalLast, int nRoute[])
+{
+    int nCur = nIndexG;
+    int nCount = 0;
+    int nPos;
+
+    if (INT_MAX == m_nDist[nMask][nCur])
+    {
+        return 0;
+    }
+    for (int j = 0; j < m_nCheckCount; j++)
+    {
+        nCount += (nMask >> j) & 1;
+    }
+    nPos = nCount - 1;
+    while (nMask != (1<<m_nDistStart))
+    {
+        int nPrevMask = nMask & ~(1<<nCur);
+        int nPrev = -1;
+        nRoute[nPos--] = nCur;
+        // 找到满足状态转移等式的前驱节点
+        for (int j = 0; j < m_nCheckCount; j++)
+        {
+            if (bGoalLast && (1 == j))
+            {
+                continue;
+            }
+            if ((nPrevMask & (1<<j)) && (INT_MAX != m_nDist[nPrevMask][j])
+                && (m_nDist[nPrevMask][j] + m_nHamilRect[j][nCur] == m_nDist[nMask][nCur]))
+            {
+                nPrev = j;
+                break;
+            }
+        }
+        nCur = nPrev;
+        nMask = nPrevMask;
+    }
+    nRoute[0] = nCur;
+    return nCount;
+}
+
+///////////////////////////////////////////////////////////////////
+// 函	数：hamiltonianRoute
+// 作	用：从DP表中回溯终止于指定终点的最短路径（节点访问顺序）
+// 参	数：int nIndexG		终点的数组索引值
+// 参	数：int nRoute[]	输出节点索引序列（至少m_nCheckCount个元素）
+// 返	回：int		返回序列长度，无解返回0
+///////////////////////////////////////////////////////////////////
+int Orienteering::hamiltonianRoute(int nIndexG, int nRoute[])
+{
+    return backtrackRoute((1<<m_nCheckCount) - 1, nIndexG, false, nRoute);
+}
+
+///////////////////////////////////////////////////////////////////
+// 函	数：hamiltonianPath
+// 作	用：求哈密顿最短路径
+// 参	数：int nIndexS		起点的数组索引值
+// 参	数：int nIndexG		终点的数组索引值
+// 返	回：int		返回设置起始两点，且经过所有节点最短路径的步数
+///////////////////////////////////////////////////////////////////
+int Orienteering::hamiltonianPath(int nIndexS, int nIndexG)
+{
+    // 同一起点的DP表已存在时直接查表
+    if (nIndexS != m_nDistStart)
+    {
+        hamiltonianSolve(nIndexS);
+    }
+    return hamiltonianCost(nIndexG);
+}
+
+///////////////////////////////////////////////////////////////////
+// 函	数：kBestSolve
+// 作	用：运算k条最短路径DP表。与hamiltonianSolve相同的子集DP，但每个
+//			状态(子集, 终点)保留步数最小的nK条路径及其前驱（前驱节点、
+//			在前驱状态中的名次）。同一状态中的路径前驱各不相同，归纳可知
+//			它们的访问顺序互不相同，因此全集终止于G的nK条即为前nK条
+//			不同访问顺序的最短路径。前驱状态的路径按步数递增，插入失败时
+//			后面的名次不必再试。G只能最后到达，不从G继续扩展
+// 参	数：int nK		每个状态保留的路径数
 // 返	回：void
 ///////////////////////////////////////////////////////////////////
-void Orienteering::main()
+void Orienteering::kBestSolve(int nK)
 {
-    // 通过example1.txt中的信息存放到m_chess数组中
-    if (!createChess())
+    int nStates = 1<<(m_nCheckCount - 1);
+    size_t nEntries = (size_t)nStates * m_nCheckCount * nK;
+
+    for (size_t i = 0; i < nEntries; i++)
     {
-        // 数据非法则直接返回
-        return;
+        m_pKBest[i].nCost = INT_MAX;
     }
-    // 分析m_chess数组，提取出解题所需信息
-    if (!analyseChess())
+    hamiltonianFloyd();
+    m_pKBest[0].nCost = 0;
+    m_pKBest[0].nPrev = 0;
+    m_pKBest[0].nRank = 0;
+
+    for (int s = 0; s < nStates; s++)
     {
-        // 数据非法则直接返回
-        return;
+        int nMask = (s<<1) | 1;
+        for (int j = 0; j < m_nCheckCount; j++)
+        {
+            if (!(nMask & (1<<j)) || (1 == j))
+            {
+                continue;
+            }
+            const MyKBestEntry* pFrom = &m_pKBest[((size_t)s * m_nCheckCount + j) * nK];
+            if (INT_MAX == pFrom[0].nCost)
+            {
+                continue;
+            }
+            for (int k = 1; k < m_nCheckCount; k++)
+            {
+                if (nMask & (1<<k))
+                {
+                    continue;
+                }
+                MyKBestEntry* pTo = &m_pKBest[((size_t)((nMask | (1<<k)) >> 1) * m_nCheckCount + k) * nK];
+                for (int r = 0; (r < nK) && (INT_MAX != pFrom[r].nCost); r++)
+                {
+                    int nCost = pFrom[r].nCost + m_nHamilRect[j][k];
+                    if (nCost >= pTo[nK - 1].nCost)
+                    {
+                        break;
+                    }
+                    // 插入排序，挤掉步数最大的一条
+                    int p = nK - 1;
+                    while ((0 < p) && (pTo[p - 1].nCost > nCost))
+                    {
+                        pTo[p] = pTo[p - 1];
+                        p--;
+                    }
+                    pTo[p].nCost = nCost;
+                    pTo[p].nPrev = (unsigned char)j;
+                    pTo[p].nRank = (unsigned char)r;
+                }
+            }
+        }
     }
-    // 根据A*算法，算出任意两点之间的最短距离，将数据存放到m_nHamiRect数组中
-    // 构成解决哈密顿最短路径的权重矩阵
-    if (createHamilRect())
+}
+
+///////////////////////////////////////////////////////////////////
+// 函	数：kBestRoute
+// 作	用：从k条最短路径DP表回溯全集、终止于G的第nRank条路径
+// 参	数：int nK			每个状态保留的路径数
+// 参	数：int nRank		名次（0为最短）
+// 参	数：int nRoute[]	输出节点索引序列（至少m_nCheckCount个元素）
+// 返	回：int		返回序列长度
+///////////////////////////////////////////////////////////////////
+int Orienteering::kBestRoute(int nK, int nRank, int nRoute[])
+{
+    int s = ((1<<m_nCheckCount) - 1) >> 1;
+    int nCur = 1;
+
+    for (int nPos = m_nCheckCount - 1; 0 < nPos; nPos--)
     {
-        // 如果发现点点相通，再进行最短路径运算
-        showDebug();
-        printf("So.The result of steps away:%d\n", hamiltonianPath(0, 1));
+        const MyKBestEntry* pEntry = &m_pKBest[((size_t)s * m_nCheckCount + nCur) * nK + nRank];
+        nRoute[nPos] = nCur;
+        nRank = pEntry->nRank;
+        s &= ~(1<<(nCur - 1));
+        nCur = pEntry->nPrev;
+    }
+    nRoute[0] = 0;
+    return m_nCheckCount;
+}
 
+///////////////////////////////////////////////////////////////////
+// 函	数：comparePrize
+// 作	用：qsort比较函数，按步数递增、分值递减排序
+///////////////////////////////////////////////////////////////////
+static int comparePrize(const void* pA, const void* pB)
+{
+    const MyPrizeEntry* a = (const MyPrizeEntry*)pA;
+    const MyPrizeEntry* b = (const MyPrizeEntry*)pB;
+    if (a->nCost != b->nCost)
+    {
+        return (a->nCost < b->nCost) ? -1 : 1;
     }
-    else
+    return (a->nScore > b->nScore) ? -1 : ((a->nScore < b->nScore) ? 1 : 0);
+}
+
+///////////////////////////////////////////////////////////////////
+// 函	数：prizeSolve
+// 作	用：运算奖励收集模式的子集DP。复用m_nHamilRect和m_nDist：
+//			m_nDist[mask][j]为从S出发经过mask、停在j的最少步数。Floyd
+//			之后矩阵满足三角不等式，从j出发至少还要m_nHamilRect[j][G]
+//			步才能到达G，超出最大预算的状态直接剪掉；没有可行状态的
+//			子集记在位图m_nLiveMask中，整字为0时一次跳过32个子集。
+//			最后把所有“停在G”的子集按步数排序，得到预算与分值的
+//			Pareto前沿，任意预算都可由前沿二分查询，一次运算回答整组预算
+// 参	数：int nBudgetMax	所有待查询预算中的最大值
+// 返	回：void
+///////////////////////////////////////////////////////////////////
+void Orienteering::prizeSolve(int nBudgetMax)
+{
+    const int nIndexS = 0;
+    const int nIndexG = 1;
+    int nFull = (1<<m_nCheckCount);
+    int nCandidate = 0;
+    int nBestScore = -1;
+
+    m_nFrontierCount = 0;
+    hamiltonianFloyd();
+    for (int m = 0; m < nFull; m++)
+    {
+        for (int n = 0; n < m_nCheckCount; n++)
+        {
+            m_nDist[m][n] = INT_MAX;
+        }
+    }
+    memset(m_nLiveMask, 0, sizeof(m_nLiveMask));
+    m_nDist[1<<nIndexS][nIndexS] = 0;
+    m_nLiveMask[(1<<nIndexS) >> 5] |= 1u << ((1<<nIndexS) & 31);
+
+    for (int i = 0; i < nFull; i++)
+    {
+        if (0 == m_nLiveMask[i >> 5])
+        {
+            // 整字没有可行子集，跳到下一个字
+            i |= 31;
+            continue;
+        }
+        if (!(m_nLiveMask[i >> 5] & (1u << (i & 31))))
+        {
+            continue;
+        }
+        for (int j = 0; j < m_nCheckCount; j++)
+        {
+            // 到达G即结束，不再从G出发
+            if (!(i & (1<<j)) || (nIndexG == j) || (INT_MAX == m_nDist[i][j]))
+            {
+                continue;
+            }
+            for (int k = 0; k < m_nCheckCount; k++)
+            {
+                if (i & (1<<k))
+                {
+                    continue;
+                }
+                int nCost = m_nDist[i][j] + m_nHamilRect[j][k];
+                // 剪枝：经过k后到达G也超出预算
+                if (nCost + m_nHamilRect[k][nIndexG] > nBudgetMax)
+                {
+                    continue;
+                }
+                if (nCost < m_nDist[i|(1<<k)][k])
+                {
+                    m_nDist[i|(1<<k)][k] = nCost;
+                    m_nLiveMask[(i|(1<<k)) >> 5] |= 1u << ((i|(1<<k)) & 31);
+                }
+            }
+        }
+    }
+    // 回溯路径需要起点索引（该表已按预算剪枝，solvePrize结束后会作废）
+    m_nDistStart = nIndexS;
+
+    // 收集停在G的子集
+    for (int i = 0; i < nFull; i++)
     {
-        // 如果发现只要存在两点无法相通，则该题无解，返回-1
-        //showDebug();
-        printf("-1\n");
+        if ((i & (1<<nIndexS)) && (i & (1<<nIndexG)) && (INT_MAX != m_nDist[i][nIndexG]))
+        {
+            int nScore = 0;
+            for (int k = 0; k < m_nCheckCount; k++)
+            {
+                nScore += (i & (1<<k)) ? m_nScore[k] : 0;
+            }
+            m_frontier[nCandidate].nMask = i;
+            m_frontier[nCandidate].nCost = m_nDist[i][nIndexG];
+            m_frontier[nCandidate].nScore = nScore;
+            nCandidate++;
+        }
+    }
+    qsort(m_frontier, nCandidate, sizeof(MyPrizeEntry), comparePrize);
+    // 只保留分值严格递增的子集，原地压缩为前沿
+    for (int c = 0; c < nCandidate; c++)
+    {
+        if (m_frontier[c].nScore > nBestScore)
+        {
+            nBestScore = m_frontier[c].nScore;
+            m_frontier[m_nFrontierCount++] = m_frontier[c];
+        }
+    }
+}
+
+///////////////////////////////////////////////////////////////////
+// 函	数：prizeQuery
+// 作	用：查询指定预算下的最优解（在前沿上二分查找）
+// 参	数：int nBudget		步数预算
+// 参	数：int nRoute[]	输出节点索引序列（至少m_nCheckCount个元素）
+// 参	数：int* pnCount	输出序列长度
+// 参	数：int* pnCost		输出实际步数
+// 返	回：int		返回收集的分值，预算内无法到达G返回-1
+///////////////////////////////////////////////////////////////////
+int Orienteering::prizeQuery(int nBudget, int nRoute[], int* pnCount, int* pnCost)
+{
+    int nLow = 0;
+    int nHigh = m_nFrontierCount - 1;
+    int nFound = -1;
 
+    while (nLow <= nHigh)
+    {
+        int nMid = (nLow + nHigh) / 2;
+        if (m_frontier[nMid].nCost <= nBudget)
+        {
+            nFound = nMid;
+            nLow = nMid + 1;
+        }
+        else
+        {
+            nHigh = nMid - 1;
+        }
+    }
+    if (-1 == nFound)
+    {
+        *pnCount = 0;
+        *pnCost = -1;
+        return -1;
     }
-    return ;
+    *pnCost = m_frontier[nFound].nCost;
+    *pnCount = backtrackRoute(m_frontier[nFound].nMask, 1, true, nRoute);
+    return m_frontier[nFound].nScore;
 }
 
-//////////////////////////////////////////////////////////////////////////
-//////////////////////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////
-// 函	数：main
-// 作	用：程序主函数
-// 参	数：int argc		输入参数个数
-// 参	数：char* argv[]	命令行参数
-// 返	回：int		给操作系统返回执行情况
+// 函	数：prizeHeuristic
+// 作	用：大点集的奖励收集：从S->G出发，反复把“分值/增加步数”最大且
+//			不超预算的'@'插入到它的最佳位置，直到无法插入。路径用链表
+//			保存，各点缓存最佳插入位置：插入新点后只有被拆开的那条边
+//			失效，最佳位置恰好是该边的点重新扫描整条路径，其他点只需
+//			比较新出现的两条边
+// 参	数：int nBudget		步数预算
+// 参	数：int* pnRoute	输出节点索引序列（至少m_nLargeCount个元素）
+// 参	数：int* pnCount	输出序列长度
+// 参	数：int* pnCost		输出实际步数
+// 返	回：int		返回收集的分值，预算内无法到达G返回-1
 ///////////////////////////////////////////////////////////////////
-int main(int argc, char* argv[])
+int Orienteering::prizeHeuristic(int nBudget, int* pnRoute, int* pnCount, int* pnCost)
 {
-    Orienteering o;
-    o.main();
-    //////////////////////////////////////////////////////////////////////
-    // 调试
-    //system("pause");
-    return 0;
+    const int n = m_nLargeCount;
+    const int* pDist = m_pLargeDist;
+    int nCost = pDist[0 * n + 1];
+    int nScore = 0;
+    int nCount = 2;
+
+    *pnCount = 0;
+    *pnCost = -1;
+    if (nCost > nBudget)
+    {
+        return -1;
+    }
+    m_nPrizeNext[0] = 1;
+    for (int k = 2; k < n; k++)
+    {
+        m_nPrizeAfter[k] = 0;
+        m_nPrizeDelta[k] = pDist[0 * n + k] + pDist[k * n + 1] - nCost;
+    }
+    while (true)
+    {
+        int nBestK = -1;
+        for (int k = 2; k < n; k++)
+        {
+            if ((-1 == m_nPrizeAfter[k]) || (nCost + m_nPrizeDelta[k] > nBudget))
+            {
+                continue;
+            }
+            // 比较 score[k] / delta，交叉相乘避免除法（delta可能为0）
+            if ((-1 == nBestK) || ((long long)m_nLargeScore[k] * (m_nPrizeDelta[nBestK] + 1)
+                > (long long)m_nLargeScore[nBestK] * (m_nPrizeDelta[k] + 1)))
+            {
+                nBestK = k;
+            }
+        }
+        if (-1 == nBestK)
+        {
+            break;
+        }
+        int a = m_nPrizeAfter[nBestK];
+        int b = m_nPrizeNext[a];
+        m_nPrizeNext[a] = nBestK;
+        m_nPrizeNext[nBestK] = b;
+        m_nPrizeAfter[nBestK] = -1;
+        nCost += m_nPrizeDelta[nBestK];
+        nScore += m_nLargeScore[nBestK];
+        nCount++;
+
+        // 更新其余点的最佳插入位置
+        for (int k = 2; k < n; k++)
+        {
+            if (-1 == m_nPrizeAfter[k])
+            {
+                continue;
+            }
+            if (a == m_nPrizeAfter[k])
+            {
+                m_nPrizeDelta[k] = INT_MAX;
+                for (int p = 0; 1 != p; p = m_nPrizeNext[p])
+                {
+                    int q = m_nPrizeNext[p];
+                    int nDelta = pDist[p * n + k] + pDist[k * n + q] - pDist[p * n + q];
+                    if (nDelta < m_nPrizeDelta[k])
+                    {
+                        m_nPrizeDelta[k] = nDelta;
+                        m_nPrizeAfter[k] = p;
+                    }
+                }
+                continue;
+            }
+            int nDelta = pDist[a * n + k] + pDist[k * n + nBestK] - pDist[a * n + nBestK];
+            if (nDelta < m_nPrizeDelta[k])
+            {
+                m_nPrizeDelta[k] = nDelta;
+                m_nPrizeAfter[k] = a;
+            }
+            nDelta = pDist[nBestK * n + k] + pDist[k * n + b] - pDist[nBestK * n + b];
+            if (nDelta < m_nPrizeDelta[k])
+            {
+                m_nPrizeDelta[k] = nDelta;
+                m_nPrizeAfter[k] = nBestK;
+            }
+        }
+    }
+    nCount = 0;
+    for (int p = 0; 1 != p; p = m_nPrizeNext[p])
+    {
+        pnRoute[nCount++] = p;
+    }
+    pnRoute[nCount++] = 1;
+    *pnCount = nCount;
+    *pnCost = nCost;
+    return nScore;
 }
@@ -0,0 +1,425 @@
+///////////////////////////////////////////////////////////////////
+// 文	件：orienteering.h
+// 功	能：定向越野求解库接口（liborienteering.a）
+//			地图中‘#’为障碍物，‘.’为可行区域，数字‘1’~‘9’为慢行区域，
+//			求起点‘S’经过所有‘@’点到达终点‘G’的最短路径
+//	用	法：
+//			Orienteering* pCtx = new Orienteering();	// 调用者持有的求解上下文
+//			pCtx->loadMap(pszText, nLength);			// 由内存中的地图文本建图
+//			pCtx->buildMatrix();						// 阶段1：点对距离矩阵
+//			pCtx->solvePath(&path);						// 阶段2：经过所有'@'的最短路径
+//			各函数返回ORIENT_OK或错误码，结果以结构体返回。
+//			上下文构造时按题干的最大地图（100x100）预先申请棋盘及各搜索
+//			引擎的缓冲区，更大的地图在载入时扩大；k条最短路径的DP表和
+//			大点集距离矩阵在首次使用时申请。缓冲区都只增不减、重复使用，
+//			同等规模的地图再次求解时不再申请内存，申请失败返回
+//			ORIENT_ERR_MEMORY。ENGINE_BFS的工作线程首次需要时创建并常驻；
+//			大点集模式在线程数大于1时每次分簇求解都会启动、回收线程；
+//			无法创建线程时改用已有的线程。库内没有全局可变状态，也不做
+//			任何输入输出，不同线程各自持有上下文即可并行求解。
+// 作	者：gengjian1203
+// 邮	箱：gengjian1203@foxmail.com
+///////////////////////////////////////////////////////////////////
+#ifndef ORIENTEERING_H
+#define ORIENTEERING_H
+
+#include <stddef.h>
+#include "grid.h"
+#include "search.h"
+#include "heuristic.h"
+#include "graph.h"
+#include "bfs.h"
+#include "cluster.h"
+
+// 根据题干，设定以下宏
+// 题干为1 <= width <= 100   1 <= height <= 100，上下文构造时按此规模预先申请缓冲区；
+// 更大的地图（最大MAX_WIDTH x MAX_HEIGHT）在载入时扩大缓冲区（只增不减）
+#define PRESET_WIDTH 100
+#define PRESET_HEIGHT 100
+#define MAX_WIDTH 4096
+#define MAX_HEIGHT 4096
+// The maximum number of point is 20 (start + goal + check)
+// 15个点为内存极限 -.-!~~如在内存可以加大的情况下可将MAX_POINT宏的数加大
+// 但占用内存成几何倍数增长）
+#define MAX_POINT 15
+#define MAX_CHECK MAX_POINT - 2
+// 大点集模式的最大点数（含S、G），超过MAX_POINT时分簇求解（cluster.h）
+#define MAX_LARGE_POINT 1024
+// k条最短路径：每个DP状态最多保留的路径数
+#define KBEST_MAX 8
+
+// 阶段1的距离计算引擎
+#define ENGINE_GRID 0		// 在棋盘上逐格搜索（无权地图用A*，带权地图用Dial）
+#define ENGINE_GRAPH 1		// 在收缩后的稀疏图上搜索（graph.h），结果与逐格搜索相同
+#define ENGINE_BFS 2		// 无权地图每点一次多线程广度优先搜索（bfs.h），带权地图同ENGINE_GRID
+
+// 错误码
+#define ORIENT_OK 0
+#define ORIENT_ERR_SIZE_LINE 1		// 首行宽高格式错误
+#define ORIENT_ERR_WIDTH 2			// 宽度超出范围
+#define ORIENT_ERR_HEIGHT 3			// 高度超出范围
+#define ORIENT_ERR_MAP_DATA 4		// 地图行数不足
+#define ORIENT_ERR_MULTI_START 5	// 'S'多于1个
+#define ORIENT_ERR_MULTI_GOAL 6		// 'G'多于1个
+#define ORIENT_ERR_MULTI_CHECK 7	// '@'多于MAX_CHECK个
+#define ORIENT_ERR_ILLEGAL_CHAR 8	// 非法字符
+#define ORIENT_ERR_NO_START 9		// 没有'S'
+#define ORIENT_ERR_NO_GOAL 10		// 没有'G'
+#define ORIENT_ERR_MEMORY 11		// 内存不足
+#define ORIENT_ERR_UNREACHABLE 12	// 存在两点无法相通，该题无解
+#define ORIENT_ERR_STATE 13			// 阶段调用顺序错误
+
+struct MyPoint
+{
+    // 该点属性
+    int x;
+    int y;
+
+};
+
+struct MyNode
+{
+    // 该点属性
+    MyPoint point;
+    // 该点star参数
+    int fAstar;
+    int hAstar;
+    int gAstar;
+    // 指向上一步骤行走的节点
+    MyNode* pParent;
+    // 指向链表中下个元素
+    MyNode* pNext;
+
+};
+
+struct MyKBestEntry
+{
+    // 从S出发经过该子集、停在该点的步数（空位为INT_MAX）
+    int nCost;
+    // 前驱节点，及该路径在前驱状态中的名次
+    unsigned char nPrev;
+    unsigned char nRank;
+
+};
+
+struct MyPrizeEntry
+{
+    // 经过的节点子集
+    int nMask;
+    // 从S经过该子集到达G的最少步数
+    int nCost;
+    // 该子集的分值
+    int nScore;
+
+};
+
+// 阶段2结果：一条路径
+struct OrientPath
+{
+    // 最短步数（无解为-1）
+    int nSteps;
+    // 路径节点数
+    int nCount;
+    // 节点访问顺序（节点索引：0为S，1为G，其余为'@'）
+    int nRoute[MAX_POINT];
+
+};
+
+// 大点集模式结果：一条路径（节点序列由调用者提供缓冲区）
+struct OrientTour
+{
+    // 路径步数（无解为-1）
+    int nSteps;
+    // 路径节点数
+    int nCount;
+    // 节点访问顺序（节点索引：0为S，1为G，其余为'@'），至少largePointCount()个元素
+    int* pRoute;
+    // pRoute的元素个数
+    int nCapacity;
+
+};
+
+// 奖励收集模式结果：一个预算下的最优解
+struct OrientPrize
+{
+    // 步数预算
+    int nBudget;
+    // 收集的分值（预算内无法到达G为-1）
+    int nScore;
+    // 实际步数
+    int nSteps;
+    // 路径节点数
+    int nCount;
+    // 节点访问顺序
+    int nRoute[MAX_POINT];
+
+};
+
+class Orienteering
+{
+public:
+    Orienteering();
+    ~Orienteering();
+    // 设置棋盘存储顺序（GRID_ROW_MAJOR或GRID_TILED），下一张地图生效
+    void setGridLayout(int nLayout) { m_nLayout = nLayout; }
+    // 设置A*估价方式（HEURISTIC_MANHATTAN或HEURISTIC_ALT），下一张地图生效
+    void setHeuristic(int nHeuristic) { m_nHeuristic = nHeuristic; }
+    // 设置阶段1的距离计算引擎（ENGINE_GRID或ENGINE_GRAPH），下一次buildMatrix生效
+    void setEngine(int nEngine) { m_nEngine = nEngine; }
+    // 设置ENGINE_BFS及大点集模式簇内求解使用的线程数（含调用线程，默认为1）
+    void setThreads(int nThreads) { m_nThreads = nThreads; m_bfs.setThreads(nThreads); }
+    // 设置大点集模式：'@'可多达MAX_LARGE_POINT - 2个，只能用solveTour求解。下一张地图生效
+    void setLargeMode(bool bLarge) { m_bLarge = bLarge; }
+    // 设置惰性距离矩阵：buildMatrix只填曼哈顿下界，solvePath用分支定界
+    // 按需运行精确搜索（结果缓存）；其他求解函数先补全矩阵。下一次buildMatrix生效
+    void setLazyMatrix(bool bLazy) { m_bLazy = bLazy; }
+
+    // 由内存中的地图文本建图（不要求以'\0'结尾）
+    int loadMap(const char* pszText, size_t nLength);
+    // 阶段1：计算所有点之间的最短距离矩阵
+    int buildMatrix();
+    // 阶段2：S经过所有'@'到达G的最短路径
+    int solvePath(OrientPath* pPath);
+    // 阶段2：一次DP得到终止于每个点的最短路径（pPath至少pointCount()个元素）
+    int solveAllGoals(OrientPath pPath[], int* pnBest);
+    // 奖励收集模式：一次运算回答多个预算（pPrize与pnBudget等长）
+    int solvePrize(const int* pnBudget, int nCount, OrientPrize pPrize[]);
+    // 大点集的奖励收集模式：贪心插入求一个预算下的较优解，*pnScore为收集的分值
+    // （预算内无法到达G为-1）
+    int solvePrizeTour(int nBudget, OrientTour* pTour, int* pnScore);
+    // 大点集模式：分簇求S经过所有'@'到达G的路径
+    int solveTour(OrientTour* pTour);
+    // 阶段2：一次DP得到S经过所有'@'到达G的前nK条最短路径（访问顺序各不相同，
+    // nK不超过KBEST_MAX，pPath至少nK个元素），*pnCount为实际条数
+    int solveKBest(int nK, OrientPath pPath[], int* pnCount);
+
+    // 地图信息查询
+    int width() const { return m_nWidth; }
+    int height() const { return m_nHeight; }
+    const char* chessRow(int y) const { return m_pChess + (size_t)y * m_nWidth; }
+    bool isWeighted() const { return m_bWeighted; }
+    int pointCount() const { return m_nCheckCount; }
+    MyPoint point(int k) const { return m_point[k]; }
+    int distance(int i, int j) const { return m_nHamilRect[i][j]; }
+    // 惰性距离矩阵：该点对是否已是精确距离（否则distance为下界）
+    bool isExact(int i, int j) const { return m_bExact[i][j]; }
+    bool isLazy() const { return m_bLazyMatrix; }
+    // 阶段1统计信息
+    int expandCount() const { return m_nExpandCount; }
+    int landmarkCount() const { return m_heuristic.landmarkCount(); }
+    int engine() const { return m_nEngine; }
+    const MyCorridorGraph& graph() const { return m_graph; }
+    const ParallelBFS& bfs() const { return m_bfs; }
+    // 大点集模式信息查询
+    bool isLarge() const { return m_bLargeMap; }
+    int largePointCount() const { return m_nLargeCount; }
+    MyPoint largePoint(int k) const { return m_largePoint[k]; }
+    int largeDistance(int i, int j) const { return m_pLargeDist[i * m_nLargeCount + j]; }
+    int clusterCount() const { return m_cluster.clusterCount(); }
+    int repairGain() const { return m_cluster.repairGain(); }
+    // k条最短路径DP表占用的字节数：(1<<(pointCount() - 1)) * pointCount() * nK * sizeof(MyKBestEntry)
+    size_t kBestMemory() const { return m_nKBestBytes; }
+    // 惰性距离矩阵统计信息：精确搜索次数、分支定界展开的节点数
+    int exactSearchCount() const { return m_nExactSearches; }
+    int boundNodeCount() const { return m_nBoundNodes; }
+
+private:
+    // 当前阶段（0：未建图，1：已建图，2：已生成距离矩阵）
+    int m_nPhase;
+    // 棋盘信息-宽
+    int m_nWidth;
+    // 棋盘信息-高
+    int m_nHeight;
+    // 棋盘信息-check点个数
+    int m_nCheckCount;
+    // 棋盘信息-明细（m_nHeight行，每行m_nWidth个字符；只增不减，重复使用）
+    char* m_pChess;
+    int m_nChessCapacity;
+    // 棋盘信息-存储层（带哨兵，所有搜索都通过它访问格子及通行代价）
+    MyGrid m_grid;
+    // 棋盘信息-存储顺序（GRID_ROW_MAJOR或GRID_TILED）
+    int m_nLayout;
+    // 棋盘信息-是否存在代价大于1的格子
+    bool m_bWeighted;
+    // 棋盘信息-节点信息
+    MyPoint m_point[MAX_POINT];					// 第0元素为start，第1元素为goal，接下来一次为check point。
+    // 哈密顿路径-距离矩阵
+    int m_nHamilRect[MAX_POINT][MAX_POINT];
+    // 哈密顿路径-行走最短步数
+    int m_nDist[(1<<MAX_POINT)][MAX_POINT];		// 问题：内存申请可能过大！！！！！
+    // 哈密顿路径-m_nDist对应的起点索引（-1表示尚未运算）
+    int m_nDistStart;
+
+    // 惰性距离矩阵-是否启用（设置值与当前矩阵实际使用的值）
+    bool m_bLazy;
+    bool m_bLazyMatrix;
+    // 惰性距离矩阵-m_nHamilRect中的点对是否已是精确距离（否则为下界）
+    bool m_bExact[MAX_POINT][MAX_POINT];
+    // 惰性距离矩阵-搜索引擎是否已准备（A*估价或收缩图，首次精确搜索时准备）
+    bool m_bLazyPrepared;
+    // 惰性距离矩阵-是否有精确搜索因内存不足失败（该点对按不通处理）
+    bool m_bLazyNoMemory;
+    // 惰性距离矩阵-精确搜索次数
+    int m_nExactSearches;
+    // 分支定界-当前路径、最优路径及其步数、展开的节点数
+    int m_nBoundRoute[MAX_POINT];
+    int m_nBestRoute[MAX_POINT];
+    int m_nBestCost;
+    int m_nBoundNodes;
+
+    // 大点集-是否启用（设置值与当前地图实际使用的值）
+    bool m_bLarge;
+    bool m_bLargeMap;
+    // 大点集-节点信息（第0元素为start，第1元素为goal，其余为check point）
+    MyPoint m_largePoint[MAX_LARGE_POINT];
+    int m_nLargeCount;
+    // 大点集-距离矩阵（m_nLargeCount * m_nLargeCount，首次使用时申请，只增不减）
+    int* m_pLargeDist;
+    int m_nLargeCapacity;
+    // 大点集-分簇求解器
+    ClusterSolver m_cluster;
+    // 簇内求解线程数
+    int m_nThreads;
+
+    // k条最短路径-DP表：状态(子集, 终点)各nK个按步数递增的路径，子集都含S，
+    // 按子集右移一位索引（首次使用时申请，只增不减）
+    MyKBestEntry* m_pKBest;
+    size_t m_nKBestCapacity;
+    // k条最短路径-当前DP表占用的字节数
+    size_t m_nKBestBytes;
+
+    // 奖励收集-各点的分值（S、G为0，'@'默认为1）
+    int m_nScore[MAX_POINT];
+    // 奖励收集-地图末尾“x,y,分值”行给出的分值
+    MyPoint m_scorePoint[MAX_LARGE_POINT];
+    int m_nScoreValue[MAX_LARGE_POINT];
+    int m_nScoreEntries;
+    // 奖励收集-m_nDist中仍有可行状态的子集（位图）
+    unsigned int m_nLiveMask[((1<<MAX_POINT) + 31) / 32];
+    // 奖励收集-预算与分值的Pareto前沿（按步数递增，分值严格递增）
+    MyPrizeEntry m_frontier[(1<<MAX_POINT)];
+    int m_nFrontierCount;
+    // 奖励收集-大点集各点的分值
+    int m_nLargeScore[MAX_LARGE_POINT];
+    // 奖励收集-大点集插入启发式：路径（链表，m_nPrizeNext[a]为a的下一个点），
+    // 各点的最佳插入位置（插在哪个点之后，已在路径中为-1）及增加的步数
+    int m_nPrizeNext[MAX_LARGE_POINT];
+    int m_nPrizeAfter[MAX_LARGE_POINT];
+    int m_nPrizeDelta[MAX_LARGE_POINT];
+
+    MyNode* listOPEN;
+    MyNode* listCLOSED;
+    // A*节点池（每个格子最多一个节点，每次A*搜索从头使用；只增不减）
+    MyNode* m_pNodePool;
+    int m_nNodeCapacity;
+    int m_nNodeCount;
+
+    // 带权地形的单源搜索引擎（Dial算法）
+    DialSearch m_dial;
+    // A*估价子系统（每张地图准备一次，所有点对共享）
+    MyHeuristic m_heuristic;
+    // A*估价方式
+    int m_nHeuristic;
+    // A*展开的节点总数（统计用）
+    int m_nExpandCount;
+    // 阶段1的距离计算引擎
+    int m_nEngine;
+    // 通道收缩图（ENGINE_GRAPH时使用）
+    MyCorridorGraph m_graph;
+    // 多线程广度优先搜索（ENGINE_BFS时使用）
+    ParallelBFS m_bfs;
+
+private:
+    ///////////////////////////////////////////////////////////////////
+    // 分析可获知信息准备阶段
+    ///////////////////////////////////////////////////////////////////
+    // 预先申请nCells个格子的棋盘明细
+    bool reserveChess(int nCells);
+    // 预先申请nCells个格子的A*节点池
+    bool reserveNodePool(int nCells);
+    // 创建棋盘信息数组
+    int createChess(const char* pszText, const char* pszEnd);
+    // 分析棋盘
+    int analyseChess();
+    ///////////////////////////////////////////////////////////////////
+    // A*算法操作阶段
+    ///////////////////////////////////////////////////////////////////
+    // 获取节点N的hAstar值
+    int gethAstar(MyPoint pointN, MyPoint pointG);
+    // 获取listOPEN表中hAstar最小的节点
+    MyNode* getBestNode();
+    // 将该点从listOPEN表移动到listCLOSED表中
+    void moveOPENtoCLOSED(MyPoint point);
+    // 将该点从listCLOSED表移动到listOPEN表中
+    void moveCLOSEDtoOPEN(MyPoint point);
+    // 判断该点是否为可行区域
+    bool isSureNode(MyPoint point);
+    // 判断该节点是否在listOPEN表中
+    MyNode* isNodeInlistOPEN(MyPoint point);
+    // 判断该节点是否在listCLOSED表中
+    MyNode* isNodeInlistCLOSED(MyPoint point);
+    // 将该节点添加到listOPEN表中
+    void inserttolistOPEN(MyNode* pInsertNode);
+    // 生成的后续节点情况处理
+    void generateList(MyNode* pParentNode, MyPoint pointChild, MyPoint pointGoal);
+    // 生成最佳节点下的子节点，填入listOPEN
+    void createChildNodeIntoOpen(MyNode *pParentNode, MyPoint pointGoal);
+    // A*算法主要流程
+    int AstarMain(MyPoint pointGoal, MyPoint pointStart);
+    ///////////////////////////////////////////////////////////////////
+    // 求最短哈密顿路径阶段
+    ///////////////////////////////////////////////////////////////////
+    // 生成哈密顿路径距离矩阵m_nHamilRect
+    int createHamilRect();
+    // 在通道收缩图上生成距离矩阵
+    int createHamilRectGraph();
+    // 用单源引擎（收缩图、Dial或多线程BFS）计算一点到各点的距离
+    bool searchRow(int nSource, const int* pnCell, int nCount, int* pnRow);
+    // 生成大点集距离矩阵
+    int createLargeRect();
+    ///////////////////////////////////////////////////////////////////
+    // 惰性距离矩阵阶段（矩阵先填下界，分支定界需要时才做精确搜索）
+    ///////////////////////////////////////////////////////////////////
+    // 生成下界矩阵
+    void createLazyRect();
+    // 取得精确距离（未计算时运行一次搜索并缓存），不通返回INT_MAX
+    int lazyDistance(int i, int j);
+    // 补全所有点对的精确距离（DP类求解函数使用）
+    int completeMatrix();
+    // 从nLast出发经过未访问节点到达G的剩余步数下界
+    int lazyBound(int nLast, int nMask);
+    // 分支定界深度优先搜索
+    void lazySearch(int nLast, int nMask, int nCost, int nDepth);
+    // 运算哈密顿Floyd
+    void hamiltonianFloyd();
+    // 以指定起点运算一次哈密顿DP表，之后可查询任意终点
+    void hamiltonianSolve(int nIndexS);
+    // 从DP表中查询经过所有节点、终止于指定终点的最短步数
+    int hamiltonianCost(int nIndexG);
+    // 从DP表中查询所有终点的最短步数，返回最佳终点索引
+    int hamiltonianAllGoals(int nCost[]);
+    // 从DP表中回溯经过指定子集、终止于指定终点的最短路径
+    int backtrackRoute(int nMask, int nIndexG, bool bGoalLast, int nRoute[]);
+    // 从DP表中回溯终止于指定终点的最短路径
+    int hamiltonianRoute(int nIndexG, int nRoute[]);
+    // 求哈密顿最短路径
+    int hamiltonianPath(int nIndexS, int nIndexG);
+    // 运算k条最短路径DP表（每个状态保留nK个）
+    void kBestSolve(int nK);
+    // 从k条最短路径DP表回溯到达G的第nRank条路径
+    int kBestRoute(int nK, int nRank, int nRoute[]);
+    ///////////////////////////////////////////////////////////////////
+    // 奖励收集定向越野阶段（给定步数预算，收集分值最高的'@'子集后到达G）
+    ///////////////////////////////////////////////////////////////////
+    // 运算子集DP，生成预算与分值的Pareto前沿
+    void prizeSolve(int nBudgetMax);
+    // 查询指定预算下的最优解
+    int prizeQuery(int nBudget, int nRoute[], int* pnCount, int* pnCost);
+    // 大点集：贪心插入求指定预算下的较优解
+    int prizeHeuristic(int nBudget, int* pnRoute, int* pnCount, int* pnCost);
+
+    Orienteering(const Orienteering&);
+    Orienteering& operator=(const Orienteering&);
+};
+
+#endif
@@ -0,0 +1,172 @@
+///////////////////////////////////////////////////////////////////
+// 文	件：search.cpp
+// 功	能：基于棋盘存储层（MyGrid）的单源搜索引擎
+// 作	者：gengjian1203
+// 邮	箱：gengjian1203@foxmail.com
+///////////////////////////////////////////////////////////////////
+#include <stdlib.h>
+#include <limits.h>
+#include "search.h"
+
+///////////////////////////////////////////////////////////////////
+// 函	数：DialSearch
+// 作	用：构造函数
+// 参	数：void
+///////////////////////////////////////////////////////////////////
+DialSearch::DialSearch()
+{
+    m_pField = NULL;
+    m_pBucketPrev = NULL;
+    m_pBucketNext = NULL;
+    m_nCapacity = 0;
+}
+
+///////////////////////////////////////////////////////////////////
+// 函	数：~DialSearch
+// 作	用：析构函数
+///////////////////////////////////////////////////////////////////
+DialSearch::~DialSearch()
+{
+    free(m_pField);
+    free(m_pBucketPrev);
+    free(m_pBucketNext);
+}
+
+///////////////////////////////////////////////////////////////////
+// 函	数：reserve
+// 作	用：预先申请nSize个格子的缓冲区（只增不减）
+// 参	数：int nSize		格子数
+// 返	回：bool		内存申请失败返回假
+///////////////////////////////////////////////////////////////////
+bool DialSearch::reserve(int nSize)
+{
+    if (nSize <= m_nCapacity)
+    {
+        return true;
+    }
+    free(m_pField);
+    free(m_pBucketPrev);
+    free(m_pBucketNext);
+    m_pField = (int*)malloc(nSize * sizeof(int));
+    m_pBucketPrev = (int*)malloc(nSize * sizeof(int));
+    m_pBucketNext = (int*)malloc(nSize * sizeof(int));
+    if ((NULL == m_pField) || (NULL == m_pBucketPrev) || (NULL == m_pBucketNext))
+    {
+        m_nCapacity = 0;
+        return false;
+    }
+    m_nCapacity = nSize;
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////
+// 函	数：insertToBucket
+// 作	用：将格子放入代价对应的桶中
+// 参	数：int nCell		格子下标
+// 参	数：int nCost		格子当前的最短代价
+// 返	回：void
+///////////////////////////////////////////////////////////////////
+void DialSearch::insertToBucket(int nCell, int nCost)
+{
+    int nBucket = nCost % (MAX_COST + 1);
+    m_pBucketPrev[nCell] = -1;
+    m_pBucketNext[nCell] = m_nBucketHead[nBucket];
+    if (-1 != m_nBucketHead[nBucket])
+    {
+        m_pBucketPrev[m_nBucketHead[nBucket]] = nCell;
+    }
+    m_nBucketHead[nBucket] = nCell;
+}
+
+///////////////////////////////////////////////////////////////////
+// 函	数：removeFromBucket
+// 作	用：将格子从代价对应的桶中取出
+// 参	数：int nCell		格子下标
+// 参	数：int nCost		格子放入桶时的最短代价
+// 返	回：void
+///////////////////////////////////////////////////////////////////
+void DialSearch::removeFromBucket(int nCell, int nCost)
+{
+    int nBucket = nCost % (MAX_COST + 1);
+    if (-1 != m_pBucketPrev[nCell])
+    {
+        m_pBucketNext[m_pBucketPrev[nCell]] = m_pBucketNext[nCell];
+    }
+    else
+    {
+        m_nBucketHead[nBucket] = m_pBucketNext[nCell];
+    }
+    if (-1 != m_pBucketNext[nCell])
+    {
+        m_pBucketPrev[m_pBucketNext[nCell]] = m_pBucketPrev[nCell];
+    }
+}
+
+///////////////////////////////////////////////////////////////////
+// 函	数：run
+// 作	用：Dial算法主要流程，计算源点到所有格子的最短代价（进入格子
+//			时累加该格子的通行代价），结果通过distance查询
+// 参	数：const MyGrid& grid	棋盘
+// 参	数：int nSource		源点格子下标
+// 返	回：bool		内存申请失败返回假
+///////////////////////////////////////////////////////////////////
+bool DialSearch::run(const MyGrid& grid, int nSource)
+{
+    int nSize = grid.size();
+    int nCur = 0;
+    int nPending = 0;
+
+    if (!reserve(nSize))
+    {
+        return false;
+    }
+    for (int i = 0; i < nSize; i++)
+    {
+        m_pField[i] = INT_MAX;
+    }
+    for (int b = 0; b <= MAX_COST; b++)
+    {
+        m_nBucketHead[b] = -1;
+    }
+    m_pField[nSource] = 0;
+    insertToBucket(nSource, 0);
+    nPending++;
+
+    while (0 < nPending)
+    {
+        // 找到下一个非空桶
+        while (-1 == m_nBucketHead[nCur % (MAX_COST + 1)])
+        {
+            nCur++;
+        }
+        int nCell = m_nBucketHead[nCur % (MAX_COST + 1)];
+        removeFromBucket(nCell, nCur);
+        nPending--;
+
+        // 哨兵保证邻居不越界，无需判断边界
+        for (int d = 0; d < 4; d++)
+        {
+            int nChild = grid.neighbour(nCell, d);
+            if (!grid.isSure(nChild))
+            {
+                continue;
+            }
+            int nCost = nCur + grid.cost(nChild);
+            if (nCost < m_pField[nChild])
+            {
+                if (INT_MAX == m_pField[nChild])
+                {
+                    nPending++;
+                }
+                else
+                {
+                    // 已在桶中，降低代价时换桶
+                    removeFromBucket(nChild, m_pField[nChild]);
+                }
+                m_pField[nChild] = nCost;
+                insertToBucket(nChild, nCost);
+            }
+        }
+    }
+    return true;
+}
@@ -0,0 +1,48 @@
+///////////////////////////////////////////////////////////////////
+// 文	件：search.h
+// 功	能：基于棋盘存储层（MyGrid）的单源搜索引擎
+//	Dial算法：通行代价均为不超过MAX_COST的小整数，待处理格子的代价
+//			总落在[当前代价, 当前代价 + MAX_COST]之内，所以MAX_COST + 1
+//			个环形桶即可代替比较堆，每次取点、改点都是O(1)
+// 作	者：gengjian1203
+// 邮	箱：gengjian1203@foxmail.com
+///////////////////////////////////////////////////////////////////
+#ifndef ORIENTEERING_SEARCH_H
+#define ORIENTEERING_SEARCH_H
+
+#include "grid.h"
+
+class DialSearch
+{
+public:
+    DialSearch();
+    ~DialSearch();
+    // 预先申请nSize个格子的缓冲区（之后不超过该规模的搜索不再申请内存）
+    bool reserve(int nSize);
+    // Dial算法主要流程，计算源点到所有格子的最短代价
+    bool run(const MyGrid& grid, int nSource);
+    // 源点到格子的最短代价，不可达为INT_MAX
+    int distance(int nCell) const { return m_pField[nCell]; }
+
+private:
+    // 各格子到源点的最短代价
+    int* m_pField;
+    // 各桶链表头（环形使用，共MAX_COST + 1个桶）
+    int m_nBucketHead[MAX_COST + 1];
+    // 桶内双向链表
+    int* m_pBucketPrev;
+    int* m_pBucketNext;
+    // 已申请的格子数（只增不减，重复使用）
+    int m_nCapacity;
+
+private:
+    // 将格子放入代价对应的桶中
+    void insertToBucket(int nCell, int nCost);
+    // 将格子从代价对应的桶中取出
+    void removeFromBucket(int nCell, int nCost);
+
+    DialSearch(const DialSearch&);
+    DialSearch& operator=(const DialSearch&);
+};
+
+#endif